@@ -9,7 +9,6 @@
  * (at your option) any later version.
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-#include <stdio.h>
 #include <stdlib.h>
 
 #if defined (unix)
@@ -22,153 +21,90 @@
 #endif
 
 #include "mcurses.h"
+#include "mcurses-gauge.h"
+#include "mcurses-sprite.h"
 
 #if defined (unix)
 #define         PAUSE(x)                        { refresh(); if (!fast) usleep (1000 * x); }
-static char *   myitoa(uint8_t x, char * buf)   { sprintf (buf, "%d", x); return buf; }
 #define         PSTR(x)                         (x)
 #elif defined (__SDCC_z80)
 #warning        SDCC Z80 port of this demo program is not fully functional yet
 #define         PAUSE(x)                        { refresh(); /* TODO */ }
-static char *   myitoa(uint8_t x, char * buf)   { sprintf (buf, "%d", x); return buf; }
 #define         PSTR(x)                         (x)
 #else // AVR
 #define         PAUSE(x)                        { refresh(); if (!fast) _delay_ms (x); }
-#define         myitoa(x,buf)                   itoa ((x), buf, 10)
 #endif
 
 static uint8_t  fast;
 
-static uint8_t  hanoi_pole_height[3];
-static uint8_t  hanoi_number_of_rings;
+#define HANOI_MAX_RINGS 8
 
-// set_position: set position on pole
-static void
-hanoi_set_position (uint8_t pole, uint8_t ring)
-{
-    uint8_t column;
-    uint8_t line;
-
-    column = pole * 20 - ring - 3;
-    line = hanoi_number_of_rings + 5 - hanoi_pole_height[pole - 1];
-    move (line, column);
-}
+static uint8_t          hanoi_pole_height[3];
+static uint8_t          hanoi_number_of_rings;
+static MCURSES_SPRITE * hanoi_rings[HANOI_MAX_RINGS];
 
-// erase ring on pole
+// background of rings: poles
 static void
-hanoi_erase_ring (uint8_t ring, uint8_t pole)
+hanoi_background (uint8_t y, uint8_t x, uint8_t * ch, uint16_t * attr, void * data)
 {
-    uint8_t i;
-    hanoi_set_position (pole, ring + 1);
-    hanoi_pole_height[pole - 1]--;
+    (void) data;
 
-    i = ring + 3;
-
-    while (i--)
+    if (y >= 4 && y <= hanoi_number_of_rings + 4 && x % 20 == 19 && x < 60)
     {
-        addch (' ');
-    }
-
-    if (hanoi_pole_height[pole - 1] - 1 == hanoi_number_of_rings)
-    {
-        addch (' ');
+        *ch = '|';
     }
     else
     {
-        addch ('|');
-    }
-
-    i = ring + 3;
-
-    while (i--)
-    {
-        addch (' ');
+        *ch = ' ';
     }
-
+    *attr = A_NORMAL;
 }
 
-// draw ring on pole
-static void
-hanoi_draw_ring (uint8_t ring, uint8_t pole)
-{
-    uint8_t i;
-
-    hanoi_pole_height[pole - 1]++;
-    hanoi_set_position (pole, ring);
-
-    i = 2 * ring + 5;
-
-    while (i--)
-    {
-        addch ('-');
-    }
-}
-
-
-// move ring from pole to pole
+// move ring from pole to pole: the sprite draws only the cells which differ
 static void
 hanoi_move_ring (uint8_t ring, uint8_t from_pole, uint8_t to_pole)
 {
-    uint8_t height[3];
-    uint8_t h;
-    uint8_t i;
-
-    height[0] = hanoi_pole_height[0];
-    height[1] = hanoi_pole_height[1];
-    height[2] = hanoi_pole_height[2];
+    MCURSES_SPRITE *    s = hanoi_rings[ring];
+    uint8_t             line;
+    uint8_t             column;
 
-    h = hanoi_number_of_rings - height[from_pole - 1] + 2;
+    line = hanoi_number_of_rings + 4 - hanoi_pole_height[to_pole - 1];
+    column = to_pole * 20 - ring - 4;
 
-    while (h)
+    while (s->begy > 3)
     {
-        hanoi_erase_ring (ring, from_pole);
-        move (3, 0);
-        PAUSE (100);
-        hanoi_pole_height[from_pole-1]++;
-        hanoi_draw_ring (ring, from_pole);
-        move (3, 0);
-        PAUSE (100);
-        h--;
+        spritemove (s, s->begy - 1, s->begx);
+        PAUSE (200);
     }
 
-    if (from_pole > to_pole)
+    while (s->begx != column)
     {
-        for (i = 0; i < 20 * (from_pole - to_pole); i++)
-        {
-            mvdelch (3,0);
-            PAUSE (25);
+#if MCURSES_VIRTUAL_SCREEN                                              // line 3 holds the ring only: shift the line,
+        if (s->begx < column)                                           // refresh() sends ICH or DCH, spritemove()
+        {                                                               // then finds its cells in place
+            mvinsch (3, 0, ' ');
+            spritemove (s, 3, s->begx + 1);
         }
-    }
-    else
-    {
-        for (i = 0; i < 20 * (to_pole - from_pole); i++)
+        else
         {
-            mvinsch (3, 0, ' ');
-            PAUSE (25);
+            mvdelch (3, 0);
+            spritemove (s, 3, s->begx - 1);
         }
+        move (3, 0);                                                    // cursor stays at the next ICH or DCH
+#else
+        spritemove (s, 3, (s->begx < column) ? s->begx + 1 : s->begx - 1);
+#endif
+        PAUSE (25);
     }
 
-    i = hanoi_number_of_rings - height[to_pole - 1] + 1;
-    hanoi_pole_height[to_pole - 1] = hanoi_number_of_rings + 1;
-
-    while (i)
+    while (s->begy < line)
     {
-        hanoi_draw_ring (ring, to_pole);
-        move (3, 0);
-        PAUSE (100);
-        hanoi_erase_ring (ring, to_pole);
-        move (3, 0);
-        PAUSE (100);
-        hanoi_pole_height[to_pole - 1]--;
-        i--;
+        spritemove (s, s->begy + 1, s->begx);
+        PAUSE (200);
     }
 
-    hanoi_draw_ring (ring, to_pole);
-    move (3, 0);
-    PAUSE (100);
-
-    hanoi_pole_height[from_pole - 1] = height[from_pole - 1] - 1;
-    hanoi_pole_height[to_pole   - 1] = height[to_pole   - 1] + 1;
+    hanoi_pole_height[from_pole - 1]--;
+    hanoi_pole_height[to_pole - 1]++;
 }
 
 static void
@@ -187,7 +123,8 @@ hanoi (uint8_t nrings, uint8_t n1, uint8_t n2, uint8_t n3)
     hanoi (n, n3, n2, n1);
 }
 
-static void
+// draw poles and rings, return FALSE if out of memory
+static uint8_t
 hanoi_draw_poles (void)
 {
     uint8_t ring;
@@ -223,10 +160,41 @@ hanoi_draw_poles (void)
         }
     }
 
-    while (ring)
+    while (ring--)                                                      // ring n is a sprite of 2 * n + 7 cells
     {
-        hanoi_draw_ring (ring, 1);
-        ring--;
+        hanoi_rings[ring] = newsprite (1, 2 * ring + 7);
+
+        if (! hanoi_rings[ring])
+        {
+            while (++ring < hanoi_number_of_rings)                      // delete rings created so far
+            {
+                spritehide (hanoi_rings[ring]);
+                delsprite (hanoi_rings[ring]);
+            }
+            return FALSE;
+        }
+
+        for (i = 0; i < 2 * ring + 7; i++)
+        {
+            spriteset (hanoi_rings[ring], 0, i, '-', A_NORMAL);
+        }
+
+        spritebackground (hanoi_rings[ring], hanoi_background, (void *) 0);
+        hanoi_pole_height[0]++;
+        spritemove (hanoi_rings[ring], hanoi_number_of_rings + 5 - hanoi_pole_height[0], 20 - ring - 4);
+        spriteshow (hanoi_rings[ring]);
+    }
+    return TRUE;
+}
+
+static void
+hanoi_delete_rings (void)
+{
+    uint8_t ring;
+
+    for (ring = 0; ring < hanoi_number_of_rings; ring++)
+    {
+        delsprite (hanoi_rings[ring]);
     }
 }
 
@@ -327,7 +295,6 @@ shift_left_str (uint8_t y, uint8_t x, char * str)
 static void
 screen_demo (void)
 {
-    char    buf[10];
     uint8_t line;
     uint8_t col;
 
@@ -383,7 +350,7 @@ screen_demo (void)
     for (line = 2; line <= LINES - 4; line++)
     {
         move (line, 0);
-        addstr (myitoa (line + 1, buf));
+        printw ("%d", line + 1);
     }
 
     PAUSE (700);
@@ -467,60 +434,75 @@ screen_demo (void)
 static void
 temperature ()
 {
-    uint8_t idx;
-    uint8_t t;
-    uint8_t x;
-    uint8_t loop;
-    char    buf[10];
-    unsigned char temp[15] = { 0, 8, 15, 21, 26, 30, 32, 35, 32, 30, 26, 21, 15, 8, 0 };
+    uint8_t         idx;
+    uint8_t         x;
+    uint8_t         loop;
+    unsigned char   temp[15] = { 0, 8, 15, 21, 26, 30, 32, 35, 32, 30, 26, 21, 15, 8, 0 };
+    WINDOW *        win;
+    MCURSES_GAUGE * gauge[15];
 
     curs_set (0);                                                       // set cursor invisible
     clear ();
     show_top_line_P (PSTR("Temperatures in a disk storage"));
     show_bottom_line_P (PSTR(""));
 
-    for (loop = 0; loop < 30; loop++)
+    win = newwin (0, 0, 0, 0);
+
+    if (! win)
     {
-        for (idx = 0; idx < 15; idx++)
-        {
-            if (temp[idx] > 30)
-            {
-                attrset (B_RED);
-            }
-            else if (temp[idx] > 20)
-            {
-                attrset (B_BROWN);
-            }
-            else
-            {
-                attrset (B_GREEN);
-            }
+        curs_set (1);
+        return;
+    }
+
+    for (idx = 0; idx < 15; idx++)
+    {
+        move (idx + 4, 20);
+        addch (ACS_LTEE);
 
-            mvaddstr (idx + 4, 5, "Disk ");
-            myitoa (idx + 1, buf);
+        gauge[idx] = newgauge (win, idx + 4, 21, 55, 55);               // bar remembers its length, draws only the difference
 
-            if (idx + 1 < 10)
+        if (! gauge[idx])
+        {
+            while (idx--)                                               // delete gauges created so far
             {
-                addch (' ');
+                delgauge (gauge[idx]);
             }
+            delwin (win);
+            curs_set (1);
+            return;
+        }
 
-            addstr (buf);
-            addstr (": ");
-            myitoa (temp[idx] + 20, buf);
-            addstr (buf);
-            addch ('');
-            attrset (A_NORMAL);
-
-            move (idx + 4, 20);
-
-            addch (ACS_LTEE);
+        gaugestyle (gauge[idx], ACS_HLINE, F_GREEN);
+        gaugelevel (gauge[idx], 21, F_BROWN);
+        gaugelevel (gauge[idx], 31, F_RED);
+    }
 
-            for (t = 0; t < temp[idx]; t++)
+    for (loop = 0; loop < 30; loop++)
+    {
+        for (idx = 0; idx < 15; idx++)
+        {
+            if (loop == 0 || gauge[idx]->value != temp[idx])
             {
-                addch (ACS_HLINE);
+                if (temp[idx] > 30)
+                {
+                    attrset (B_RED);
+                }
+                else if (temp[idx] > 20)
+                {
+                    attrset (B_BROWN);
+                }
+                else
+                {
+                    attrset (B_GREEN);
+                }
+
+                mvprintw_P (idx + 4, 5, PSTR("Disk %2d: %d"), idx + 1, temp[idx] + 20);
+                add_wch (0x00B0);                                       // degree sign
+                attrset (A_NORMAL);
             }
 
-            clrtoeol ();
+            gaugeset (gauge[idx], temp[idx]);
+            gaugedraw (gauge[idx]);
 
             x = rand() & 0x1F;
 
@@ -542,44 +524,32 @@ temperature ()
         PAUSE (100);
     }
 
+    for (idx = 0; idx < 15; idx++)
+    {
+        delgauge (gauge[idx]);
+    }
+    delwin (win);
+
     curs_set (1);                                                       // set cursor visible (normal)
 }
 
+// draw box on stdscr, needs no window and no heap
 static void
 drawbox (uint8_t y, uint8_t x, uint8_t h, uint8_t w)
 {
-    uint8_t line;
-    uint8_t col;
-
-    move (y, x);
-    addch (ACS_ULCORNER);
-    for (col = 0; col < w - 2; col++)
-    {
-        addch (ACS_HLINE);
-    }
-    addch (ACS_URCORNER);
-
-    for (line = 0; line < h - 2; line++)
-    {
-        move (line + y + 1, x);
-        addch (ACS_VLINE);
-        move (line + y + 1, x + w - 1);
-        addch (ACS_VLINE);
-    }
-
-    move (y + h - 1, x);
-    addch (ACS_LLCORNER);
-    for (col = 0; col < w - 2; col++)
-    {
-        addch (ACS_HLINE);
-    }
-    addch (ACS_LRCORNER);
+    mvaddch (y, x, ACS_ULCORNER);
+    hline (0, w - 2);
+    mvaddch (y, x + w - 1, ACS_URCORNER);
+    mvvline (y + 1, x, 0, h - 2);
+    mvvline (y + 1, x + w - 1, 0, h - 2);
+    mvaddch (y + h - 1, x, ACS_LLCORNER);
+    hline (0, w - 2);
+    mvaddch (y + h - 1, x + w - 1, ACS_LRCORNER);
 }
 
 int
 main ()
 {
-    char    buf[10];
     uint8_t idx;
     uint8_t cnt;
     uint8_t ch;
@@ -595,8 +565,7 @@ main ()
         for (idx = 3; idx > 0; idx--)
         {
             move (10, 40);
-            myitoa(idx, buf);
-            addstr (buf);
+            printw ("%d", idx);
             PAUSE (1000);
         }
 
@@ -614,9 +583,14 @@ main ()
         hanoi_pole_height[1] = 0;
         hanoi_pole_height[2] = 0;
 
-        hanoi_draw_poles ();
-        hanoi (hanoi_number_of_rings, 1, 2, 3);
-        PAUSE (1000);
+        curs_set (0);                                                   // set cursor invisible
+        if (hanoi_draw_poles ())
+        {
+            hanoi (hanoi_number_of_rings, 1, 2, 3);
+            PAUSE (1000);
+            hanoi_delete_rings ();
+        }
+        curs_set (1);                                                   // set cursor visible (normal)
 
         temperature ();
 
@@ -626,7 +600,7 @@ main ()
         for (idx = 1; idx <= 6; idx++)
         {
             mvaddstr_P (idx + 7, 23, PSTR("This is line "));
-            addstr (myitoa(idx, buf));
+            printw ("%d", idx);
             PAUSE (400);
         }
         PAUSE (1000);
@@ -638,9 +612,7 @@ main ()
         while (1)
         {
             move (11, 10);
-            addstr_P (PSTR("Timeout Counter: "));
-            addstr (myitoa(cnt, buf));
-            addstr_P (PSTR(" tenths of a sec"));
+            printw_P (PSTR("Timeout Counter: %d tenths of a sec"), cnt);
             clrtoeol ();
 
             move (10, 10);
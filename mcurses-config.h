@@ -13,3 +13,19 @@
 #define MCURSES_BAUD                19200L          // UART baudrate
 #define MCURSES_LINES               24              // 24 lines
 #define MCURSES_COLS                80              // 80 columns
+#define MCURSES_OUTQ_SIZE           65536L          // UNIX: size of output queue for asyncoutput(), must be a power of 2
+#define MCURSES_PAGER_STEP          1024            // UNIX: pager indexes the offset of every n-th line of the file
+#define MCURSES_COLOR_PAIRS         16              // number of color pairs including pair 0 (default colors), see init_pair(), max. 256
+#define MCURSES_PALETTE             64              // virtual screen: max. number of distinct attributes in use, max. 255
+
+#if defined(unix)
+#ifndef MCURSES_VIRTUAL_SCREEN                      // may be set by the compiler, e.g. -DMCURSES_VIRTUAL_SCREEN=0
+#define MCURSES_VIRTUAL_SCREEN      1               // 1: keep screen in memory, refresh() sends differences only
+#endif
+#define MCURSES_UTF8                1               // 1: terminal speaks UTF-8, strings are UTF-8, see add_wch()
+#define MCURSES_UNICODE_ACS         0               // 0: ACS characters from G1 set, 1: as Unicode box drawing characters (opt-in)
+#else
+#define MCURSES_VIRTUAL_SCREEN      0               // 0: send output immediately (AVR, Z80: not enough RAM)
+#define MCURSES_UTF8                0               // 0: 8 bit characters only, no width table in flash
+#define MCURSES_UNICODE_ACS         0               // 0: ACS characters from G1 set, switched with SO/SI
+#endif
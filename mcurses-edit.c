@@ -0,0 +1,594 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-edit.c - line editor for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-edit.h"
+
+#define EDIT_SHIFT_MIN          4                                                   // shift by ICH/DCH if more characters follow
+#define EDIT_GETNSTR_HISTORY    8                                                   // editgetnstr(): size of history ring
+
+static WINDOW                   mcurses_edit_line;                                  // editgetnstr(): rest of cursor line
+static MCURSES_EDIT *           mcurses_edit_getnstr;                               // editgetnstr(): editor keeping the history
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: remember change at position idx of text, shift = 1: one character inserted, -1: one character deleted
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_changed (MCURSES_EDIT * ed, uint16_t idx, int8_t shift)
+{
+    if (ed->mod == EDIT_NONE)
+    {
+        ed->mod     = idx;
+        ed->shift   = shift;
+    }
+    else
+    {
+        if (idx < ed->mod)
+        {
+            ed->mod = idx;
+        }
+        ed->shift = 0;                                                          // more than one change: redraw from mod
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: delete characters from position from to position to (exclusive)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_delete (MCURSES_EDIT * ed, uint16_t from, uint16_t to)
+{
+    if (from < to)
+    {
+        memmove (ed->buf + from, ed->buf + to, ed->len - to + 1);
+        ed->len -= to - from;
+        mcurses_edit_changed (ed, from, (to - from == 1) ? -1 : 0);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: replace text, cursor goes to end
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_replace (MCURSES_EDIT * ed, const char * str)
+{
+    uint16_t    len = strlen (str);
+
+    if (len >= ed->size)
+    {
+        len = ed->size - 1;
+    }
+
+    memcpy (ed->buf, str, len);
+    ed->buf[len]    = '\0';
+    ed->len         = len;
+    ed->pos         = len;
+    mcurses_edit_changed (ed, 0, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return position of start of word left of pos
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint16_t
+mcurses_edit_wordleft (MCURSES_EDIT * ed)
+{
+    uint16_t    pos = ed->pos;
+
+    while (pos > 0 && ed->buf[pos - 1] == ' ')
+    {
+        pos--;
+    }
+
+    while (pos > 0 && ed->buf[pos - 1] != ' ')
+    {
+        pos--;
+    }
+    return pos;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return position of start of word right of pos
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint16_t
+mcurses_edit_wordright (MCURSES_EDIT * ed)
+{
+    uint16_t    pos = ed->pos;
+
+    while (pos < ed->len && ed->buf[pos] != ' ')
+    {
+        pos++;
+    }
+
+    while (pos < ed->len && ed->buf[pos] == ' ')
+    {
+        pos++;
+    }
+    return pos;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: show history entry n (1 = newest), 0 = own text
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_history (MCURSES_EDIT * ed, uint8_t n)
+{
+    if (ed->hist_idx == 0)                                                      // save own text first
+    {
+        ed->saved = malloc (ed->len + 1);
+
+        if (! ed->saved)
+        {
+            return;
+        }
+        memcpy (ed->saved, ed->buf, ed->len + 1);
+    }
+
+    ed->hist_idx = n;
+
+    if (n > 0)
+    {
+        mcurses_edit_replace (ed, ed->hist[(ed->hist_head + ed->hist_size - n) % ed->hist_size]);
+    }
+    else
+    {
+        mcurses_edit_replace (ed, ed->saved);
+        free (ed->saved);
+        ed->saved = (char *) 0;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: move cursor to column col of field, if it's not already there
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_move (MCURSES_EDIT * ed, uint8_t col)
+{
+    uint8_t     y;
+    uint8_t     x;
+
+    getyx (y, x);
+
+    if (y != ed->win->begy + ed->y || x != ed->win->begx + ed->x + col)
+    {
+        (void) wmove (ed->win, ed->y, ed->x + col);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw characters from position from to position to (exclusive), spaces behind end of text
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_edit_drawchars (MCURSES_EDIT * ed, uint16_t from, uint16_t to)
+{
+    uint8_t     ch;
+
+    if (from < to)
+    {
+        mcurses_edit_move (ed, from - ed->left);
+
+        while (from < to)
+        {
+            ch = (from < ed->len) ? ed->buf[from] : ' ';
+            addch ((ch < ' ') ? ' ' : ch);
+            from++;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: create line editor for a text of up to size - 1 characters (max. 65534), shown in a field of width cells at
+ * line y, column x of window. Returns NULL if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_EDIT *
+newedit (WINDOW * win, uint8_t y, uint8_t x, uint8_t width, uint16_t size)
+{
+    MCURSES_EDIT *  ed;
+
+    ed = calloc (1, sizeof (MCURSES_EDIT));
+
+    if (ed)
+    {
+        ed->buf = malloc (size ? size : 1);
+
+        if (! ed->buf)
+        {
+            free (ed);
+            return (MCURSES_EDIT *) 0;
+        }
+
+        ed->win         = win;
+        ed->y           = y;
+        ed->x           = x;
+        ed->width       = width ? width : 1;
+        ed->size        = size ? size : 1;
+        ed->buf[0]      = '\0';
+        ed->drawn_left  = EDIT_NONE;
+        ed->mod         = EDIT_NONE;
+    }
+    return ed;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: delete line editor, the contents of the window remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+deledit (MCURSES_EDIT * ed)
+{
+    (void) edithistory (ed, 0);
+    free (ed->buf);
+    free (ed);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: set size of history ring, 0 = no history. The history is cleared. Returns ERR if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+edithistory (MCURSES_EDIT * ed, uint8_t n)
+{
+    uint8_t     i;
+
+    for (i = 0; i < ed->hist_count; i++)
+    {
+        free (ed->hist[i]);
+    }
+
+    free (ed->hist);
+    free (ed->saved);
+    ed->hist        = (char **) 0;
+    ed->saved       = (char *) 0;
+    ed->hist_size   = 0;
+    ed->hist_count  = 0;
+    ed->hist_head   = 0;
+    ed->hist_idx    = 0;
+
+    if (n > 0)
+    {
+        ed->hist = calloc (n, sizeof (char *));
+
+        if (! ed->hist)
+        {
+            return ERR;
+        }
+        ed->hist_size = n;
+    }
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: set text, cursor goes to end
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+editset (MCURSES_EDIT * ed, const char * str)
+{
+    free (ed->saved);
+    ed->saved       = (char *) 0;
+    ed->hist_idx    = 0;
+    mcurses_edit_replace (ed, str);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: add text to history, if it is not empty and differs from the newest entry. The text remains.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+editaccept (MCURSES_EDIT * ed)
+{
+    char *      entry;
+
+    free (ed->saved);
+    ed->saved       = (char *) 0;
+    ed->hist_idx    = 0;
+
+    if (ed->hist_size == 0 || ed->len == 0)
+    {
+        return;
+    }
+
+    if (ed->hist_count > 0 && ! strcmp (ed->hist[(ed->hist_head + ed->hist_size - 1) % ed->hist_size], ed->buf))
+    {
+        return;
+    }
+
+    entry = malloc (ed->len + 1);
+
+    if (entry)
+    {
+        memcpy (entry, ed->buf, ed->len + 1);
+        free (ed->hist[ed->hist_head]);                                         // oldest entry, if ring is full
+        ed->hist[ed->hist_head] = entry;
+        ed->hist_head = (ed->hist_head + 1) % ed->hist_size;
+
+        if (ed->hist_count < ed->hist_size)
+        {
+            ed->hist_count++;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: handle key: printable characters are inserted. KEY_LEFT, KEY_RIGHT, KEY_HOME, KEY_END, KEY_CLEFT and KEY_CRIGHT
+ * move the cursor, KEY_BACKSPACE and KEY_DC delete a character, CTRL-W the word left of the cursor, CTRL-U all left and
+ * CTRL-K all right of the cursor. KEY_UP and KEY_DOWN browse the history. Returns TRUE if the key has been handled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+editkey (MCURSES_EDIT * ed, uint8_t ch)
+{
+    switch (ch)
+    {
+        case KEY_LEFT:
+            if (ed->pos > 0)
+            {
+                ed->pos--;
+            }
+            break;
+        case KEY_RIGHT:
+            if (ed->pos < ed->len)
+            {
+                ed->pos++;
+            }
+            break;
+        case KEY_HOME:
+            ed->pos = 0;
+            break;
+        case KEY_END:
+            ed->pos = ed->len;
+            break;
+        case KEY_CLEFT:
+            ed->pos = mcurses_edit_wordleft (ed);
+            break;
+        case KEY_CRIGHT:
+            ed->pos = mcurses_edit_wordright (ed);
+            break;
+        case KEY_BACKSPACE:
+            if (ed->pos > 0)
+            {
+                ed->pos--;
+                mcurses_edit_delete (ed, ed->pos, ed->pos + 1);
+            }
+            break;
+        case KEY_DC:
+            if (ed->pos < ed->len)
+            {
+                mcurses_edit_delete (ed, ed->pos, ed->pos + 1);
+            }
+            break;
+        case 'W' - '@':                                                         // CTRL-W: delete word left
+        {
+            uint16_t pos = mcurses_edit_wordleft (ed);
+
+            mcurses_edit_delete (ed, pos, ed->pos);
+            ed->pos = pos;
+            break;
+        }
+        case 'U' - '@':                                                         // CTRL-U: delete to start of line
+            mcurses_edit_delete (ed, 0, ed->pos);
+            ed->pos = 0;
+            break;
+        case 'K' - '@':                                                         // CTRL-K: delete to end of line
+            mcurses_edit_delete (ed, ed->pos, ed->len);
+            break;
+        case KEY_UP:
+            if (ed->hist_idx < ed->hist_count)
+            {
+                mcurses_edit_history (ed, ed->hist_idx + 1);
+            }
+            break;
+        case KEY_DOWN:
+            if (ed->hist_idx > 0)
+            {
+                mcurses_edit_history (ed, ed->hist_idx - 1);
+            }
+            break;
+        default:
+            if ((ch & 0x7F) < 32 || (ch & 0x7F) == 127)                         // not printable ascii 7bit or 8bit ISO8859
+            {
+                return FALSE;
+            }
+
+            if (ed->len < ed->size - 1)
+            {
+                memmove (ed->buf + ed->pos + 1, ed->buf + ed->pos, ed->len - ed->pos + 1);
+                ed->buf[ed->pos] = ch;
+                ed->len++;
+                mcurses_edit_changed (ed, ed->pos, 1);
+                ed->pos++;
+            }
+            break;
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: screen has been cleared, the next editdraw() draws the whole field
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+edittouch (MCURSES_EDIT * ed)
+{
+    ed->drawn_left = EDIT_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: draw changes into window with current attribute, the caller calls refresh() afterwards
+ *
+ * Only characters from the first change on are drawn, so typing at the end of the text costs one character. If the field
+ * ends at the right edge of the screen, a single inserted or deleted character in front of a longer tail is sent as
+ * insch() or delch(). If the cursor leaves the field, the field scrolls by half its width.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+editdraw (MCURSES_EDIT * ed)
+{
+    uint16_t    end;
+    uint16_t    to;
+    uint16_t    tail;
+
+    if (ed->pos < ed->left)
+    {
+        ed->left = (ed->pos > ed->width / 2) ? ed->pos - ed->width / 2 : 0;
+    }
+    else if (ed->pos >= (uint32_t) ed->left + ed->width)
+    {
+        ed->left = ed->pos - ed->width / 2;
+    }
+
+    end = ((uint32_t) ed->left + ed->width < EDIT_NONE) ? ed->left + ed->width : EDIT_NONE;
+
+    if (ed->drawn_left != ed->left)
+    {
+        mcurses_edit_drawchars (ed, ed->left, end);
+    }
+    else if (ed->mod != EDIT_NONE && ed->mod < end)
+    {
+        to      = ((ed->len > ed->drawn_len) ? ed->len : ed->drawn_len);
+        to      = (to < end) ? to : end;
+        tail    = (ed->len < end) ? ed->len : end;
+        tail    = (tail > ed->mod + 1) ? tail - ed->mod - 1 : 0;               // visible characters right of change
+
+        if (ed->shift != 0 && ed->mod >= ed->left && tail >= EDIT_SHIFT_MIN &&
+            ed->win->begx + ed->x + ed->width == COLS)                          // field ends at right edge of screen
+        {
+            mcurses_edit_move (ed, ed->mod - ed->left);
+
+            if (ed->shift > 0)
+            {
+                insch (ed->buf[ed->mod]);
+            }
+            else
+            {
+                delch ();
+
+                if (end - 1 < ed->len)
+                {
+                    mcurses_edit_drawchars (ed, end - 1, end);                  // character moving into last column
+                }
+            }
+        }
+        else
+        {
+            mcurses_edit_drawchars (ed, (ed->mod > ed->left) ? ed->mod : ed->left, to);
+        }
+    }
+
+    mcurses_edit_move (ed, ed->pos - ed->left);
+    ed->drawn_left  = ed->left;
+    ed->drawn_len   = ed->len;
+    ed->mod         = EDIT_NONE;
+    ed->shift       = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: edit text until KEY_CR is pressed, add it to history and return it
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+char *
+editgetstr (MCURSES_EDIT * ed)
+{
+    uint8_t     ch;
+
+    editdraw (ed);
+
+    while ((ch = getch ()) != KEY_CR)
+    {
+        (void) editkey (ed, ch);
+        editdraw (ed);
+    }
+
+    editaccept (ed);
+    return ed->buf;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * EDIT: read string of up to maxlen - 1 characters (max. 65534) at cursor position, replaces getnstr() for longer input.
+ * The field reaches to the right margin and scrolls horizontally, the text is edited in str itself. The last
+ * EDIT_GETNSTR_HISTORY inputs can be recalled with KEY_UP and KEY_DOWN. Returns ERR if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+editgetnstr (char * str, uint16_t maxlen)
+{
+    MCURSES_EDIT *  ed = mcurses_edit_getnstr;
+    uint8_t         y;
+    uint8_t         x;
+
+    if (maxlen == 0)
+    {
+        return ERR;
+    }
+
+    if (! ed)                                                                   // first call: create editor with history
+    {
+        ed = newedit (&mcurses_edit_line, 0, 0, 1, 1);
+
+        if (! ed)
+        {
+            str[0] = '\0';
+            return ERR;
+        }
+
+        (void) edithistory (ed, EDIT_GETNSTR_HISTORY);                          // no memory: works without history
+        free (ed->buf);                                                         // buffer is str of caller
+        mcurses_edit_getnstr = ed;
+    }
+
+    getyx (y, x);
+
+    if (x >= COLS)                                                              // cursor behind right margin: no room for a field
+    {                                                                           // on this line, wrap to the next one
+        x = 0;
+
+        if (y < LINES - 1)
+        {
+            y++;
+        }
+    }
+
+    mcurses_edit_line.begy          = y;                                        // one line window from cursor to right margin
+    mcurses_edit_line.begx          = x;
+    mcurses_edit_line.maxy          = 1;
+    mcurses_edit_line.maxx          = COLS - x;
+    mcurses_edit_line.cury          = 0;
+    mcurses_edit_line.curx          = 0;
+    mcurses_edit_line.scrl_start    = 0;
+    mcurses_edit_line.scrl_end      = 0;
+    mcurses_edit_line.scroll        = FALSE;
+
+    str[0]          = '\0';
+    ed->buf         = str;
+    ed->size        = maxlen;
+    ed->width       = COLS - x;
+    ed->len         = 0;
+    ed->pos         = 0;
+    ed->left        = 0;
+    ed->drawn_left  = EDIT_NONE;
+    ed->mod         = EDIT_NONE;
+    ed->shift       = 0;
+
+    (void) editgetstr (ed);
+
+    ed->buf = (char *) 0;
+    return OK;
+}
@@ -0,0 +1,62 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-edit.h - include file for mcurses line editor
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_EDIT_H
+#define MCURSES_EDIT_H
+
+#include "mcurses.h"
+
+#define EDIT_NONE               0xFFFF                                              // no position
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * line editor: field of width cells showing a part of a text buffer, see newedit()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of field
+    uint8_t             y;                                                          // line in window
+    uint8_t             x;                                                          // column in window
+    uint8_t             width;                                                      // width of field
+    char *              buf;                                                        // text buffer: size bytes
+    uint16_t            size;                                                       // size of buffer including '\0'
+    uint16_t            len;                                                        // length of text
+    uint16_t            pos;                                                        // cursor position in text
+    uint16_t            left;                                                       // first visible character
+    uint16_t            drawn_left;                                                 // left of last editdraw() or EDIT_NONE
+    uint16_t            drawn_len;                                                  // length of text at last editdraw()
+    uint16_t            mod;                                                        // first changed character or EDIT_NONE
+    int8_t              shift;                                                      // one character inserted (1) or deleted (-1) at mod
+    char **             hist;                                                       // history ring: hist_size entries
+    uint8_t             hist_size;                                                  // size of history ring
+    uint8_t             hist_count;                                                 // number of entries in history
+    uint8_t             hist_head;                                                  // index of next entry
+    uint8_t             hist_idx;                                                   // entry shown: 0 = own text, 1 = newest entry
+    char *              saved;                                                      // own text while browsing history
+} MCURSES_EDIT;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * line editor functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_EDIT *           newedit (WINDOW *, uint8_t, uint8_t, uint8_t, uint16_t);   // create editor: line, column, width, size
+extern void                     deledit (MCURSES_EDIT *);                           // delete editor, contents of window remain
+extern uint8_t                  edithistory (MCURSES_EDIT *, uint8_t);              // set size of history ring
+extern void                     editset (MCURSES_EDIT *, const char *);             // set text, cursor goes to end
+extern void                     editaccept (MCURSES_EDIT *);                        // add text to history
+extern uint8_t                  editkey (MCURSES_EDIT *, uint8_t);                  // handle key, TRUE if handled
+extern void                     edittouch (MCURSES_EDIT *);                         // screen has been cleared, redraw all
+extern void                     editdraw (MCURSES_EDIT *);                          // draw changes, refresh() by caller
+extern char *                   editgetstr (MCURSES_EDIT *);                        // edit until KEY_CR, add to history
+extern uint8_t                  editgetnstr (char *, uint16_t);                     // like getnstr(): up to 65534 characters, history
+
+#endif // MCURSES_EDIT_H
@@ -0,0 +1,298 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-form.c - forms for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-form.h"
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: validate field, return TRUE if valid
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_form_check (MCURSES_FORM * form, uint16_t idx)
+{
+    MCURSES_FIELD * f = form->fields + idx;
+
+    f->invalid = (f->func && ! (*f->func) (idx, f->ed->buf, f->data));
+    return ! f->invalid;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw field, if its text, its scroll position or its attribute has changed
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_form_drawfield (MCURSES_FORM * form, uint16_t idx)
+{
+    MCURSES_FIELD * f   = form->fields + idx;
+    MCURSES_EDIT *  ed  = f->ed;
+    uint16_t        attr;
+
+    if (f->invalid)
+    {
+        attr = form->error_attr;
+    }
+    else
+    {
+        attr = (idx == form->cur) ? f->focus_attr : f->attr;
+    }
+
+    if (attr != f->drawn_attr)
+    {
+        edittouch (ed);
+        f->drawn_attr = attr;
+    }
+
+    if (ed->drawn_left == EDIT_NONE || ed->mod != EDIT_NONE || ed->pos < ed->left || ed->pos >= (uint32_t) ed->left + ed->width)
+    {
+        attrset (attr);
+        editdraw (ed);
+    }
+    else if (idx == form->cur)
+    {
+        editdraw (ed);                                                          // nothing to draw: only move cursor
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: create form with up to maxfields fields in window. Returns NULL if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_FORM *
+newform (WINDOW * win, uint16_t maxfields)
+{
+    MCURSES_FORM *  form;
+
+    form = calloc (1, sizeof (MCURSES_FORM));
+
+    if (form)
+    {
+        form->fields = calloc (maxfields, sizeof (MCURSES_FIELD));
+
+        if (! form->fields)
+        {
+            free (form);
+            return (MCURSES_FORM *) 0;
+        }
+
+        form->win           = win;
+        form->maxfields     = maxfields;
+        form->attr          = A_UNDERLINE;
+        form->focus_attr    = A_REVERSE;
+        form->error_attr    = F_RED | A_REVERSE;
+    }
+    return form;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: delete form and its fields, the contents of the window remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delform (MCURSES_FORM * form)
+{
+    uint16_t    idx;
+
+    for (idx = 0; idx < form->nfields; idx++)
+    {
+        deledit (form->fields[idx].ed);
+    }
+
+    free (form->fields);
+    free (form);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: set attribute of fields added from now on, attribute of those fields with focus and attribute of invalid fields
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+formattrset (MCURSES_FORM * form, uint16_t attr, uint16_t focus_attr, uint16_t error_attr)
+{
+    form->attr          = attr;
+    form->focus_attr    = focus_attr;
+    form->error_attr    = error_attr;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: add field of width cells at line y, column x of window for a text of up to size - 1 characters. func validates
+ * the text when the field loses focus, it may be NULL. Returns number of field or FORM_NONE if there is no room.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint16_t
+formaddfield (MCURSES_FORM * form, uint8_t y, uint8_t x, uint8_t width, uint16_t size, MCURSES_FORM_FUNC func, void * data)
+{
+    MCURSES_FIELD * f;
+
+    if (form->nfields == form->maxfields)
+    {
+        return FORM_NONE;
+    }
+
+    f = form->fields + form->nfields;
+    f->ed = newedit (form->win, y, x, width, size);
+
+    if (! f->ed)
+    {
+        return FORM_NONE;
+    }
+
+    f->func         = func;
+    f->data         = data;
+    f->attr         = form->attr;
+    f->focus_attr   = form->focus_attr;
+    f->invalid      = FALSE;
+    return form->nfields++;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: set attribute of field and attribute of field with focus
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+formfieldattr (MCURSES_FORM * form, uint16_t idx, uint16_t attr, uint16_t focus_attr)
+{
+    form->fields[idx].attr          = attr;
+    form->fields[idx].focus_attr    = focus_attr;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: set text of field
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+formset (MCURSES_FORM * form, uint16_t idx, const char * str)
+{
+    editset (form->fields[idx].ed, str);
+    form->fields[idx].invalid = FALSE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: get text of field
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+char *
+formget (MCURSES_FORM * form, uint16_t idx)
+{
+    return form->fields[idx].ed->buf;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: move focus to field. Returns FALSE and keeps the focus, if the field with focus is invalid.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+formfocus (MCURSES_FORM * form, uint16_t idx)
+{
+    if (idx >= form->nfields || ! mcurses_form_check (form, form->cur))
+    {
+        return FALSE;
+    }
+
+    form->cur = idx;
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: validate all fields. Returns the first invalid field, which gets the focus, or FORM_NONE if all are valid.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint16_t
+formvalidate (MCURSES_FORM * form)
+{
+    uint16_t    first = FORM_NONE;
+    uint16_t    idx;
+
+    for (idx = 0; idx < form->nfields; idx++)
+    {
+        if (! mcurses_form_check (form, idx) && first == FORM_NONE)
+        {
+            first = idx;
+        }
+    }
+
+    if (first != FORM_NONE)
+    {
+        form->cur = first;
+    }
+    return first;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: handle key: KEY_TAB and KEY_BTAB move the focus to the next/previous field, if the field with focus is valid.
+ * Other keys go to the line editor of the field with focus, see editkey(). Returns TRUE if the key has been handled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+formkey (MCURSES_FORM * form, uint8_t ch)
+{
+    if (form->nfields == 0)
+    {
+        return FALSE;
+    }
+
+    switch (ch)
+    {
+        case KEY_TAB:
+            (void) formfocus (form, (form->cur + 1 < form->nfields) ? form->cur + 1 : 0);
+            break;
+        case KEY_BTAB:
+            (void) formfocus (form, (form->cur > 0) ? form->cur - 1 : form->nfields - 1);
+            break;
+        default:
+            return editkey (form->fields[form->cur].ed, ch);
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: screen has been cleared, the next formdraw() draws all fields
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+formtouch (MCURSES_FORM * form)
+{
+    uint16_t    idx;
+
+    for (idx = 0; idx < form->nfields; idx++)
+    {
+        edittouch (form->fields[idx].ed);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * FORM: draw changed fields into window, caller must call refresh() to show them
+ *
+ * Only fields whose text has changed or which got or lost the focus or their validity are drawn, see editdraw(). The
+ * cursor is placed in the field with focus. The attribute of the field drawn last remains set.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+formdraw (MCURSES_FORM * form)
+{
+    uint16_t    idx;
+
+    for (idx = 0; idx < form->nfields; idx++)
+    {
+        if (idx != form->cur)
+        {
+            mcurses_form_drawfield (form, idx);
+        }
+    }
+
+    if (form->nfields > 0)
+    {
+        mcurses_form_drawfield (form, form->cur);                               // last: cursor stays in field with focus
+    }
+}
@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-form.h - include file for mcurses forms
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_FORM_H
+#define MCURSES_FORM_H
+
+#include "mcurses-edit.h"
+
+#define FORM_NONE               0xFFFF                                              // no field
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * validation callback: return TRUE if text of field is valid
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef uint8_t (* MCURSES_FORM_FUNC) (uint16_t field, const char * text, void * data);
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * field of a form
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    MCURSES_EDIT *      ed;                                                         // line editor of field
+    MCURSES_FORM_FUNC   func;                                                       // validation callback or NULL
+    void *              data;                                                       // argument of validation callback
+    uint16_t            attr;                                                       // attribute of field
+    uint16_t            focus_attr;                                                 // attribute of field with focus
+    uint16_t            drawn_attr;                                                 // attribute of field on screen
+    uint8_t             invalid;                                                    // TRUE: validation has failed
+} MCURSES_FIELD;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * form: input fields in a window, see newform()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of form
+    MCURSES_FIELD *     fields;                                                     // fields: maxfields entries
+    uint16_t            nfields;                                                    // number of fields
+    uint16_t            maxfields;                                                  // max. number of fields
+    uint16_t            cur;                                                        // field with focus
+    uint16_t            attr;                                                       // default attribute of new fields ...
+    uint16_t            focus_attr;                                                 // ... and of new fields with focus
+    uint16_t            error_attr;                                                 // attribute of invalid fields
+} MCURSES_FORM;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * form functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_FORM *           newform (WINDOW *, uint16_t);                       // create form with max. n fields
+extern void                     delform (MCURSES_FORM *);                           // delete form, contents of window remain
+extern void                     formattrset (MCURSES_FORM *, uint16_t, uint16_t, uint16_t);    // set default, focus and error attribute
+extern uint16_t                 formaddfield (MCURSES_FORM *, uint8_t, uint8_t, uint8_t, uint16_t, MCURSES_FORM_FUNC, void *);  // add field
+extern void                     formfieldattr (MCURSES_FORM *, uint16_t, uint16_t, uint16_t);  // set attributes of field
+extern void                     formset (MCURSES_FORM *, uint16_t, const char *);   // set text of field
+extern char *                   formget (MCURSES_FORM *, uint16_t);                 // get text of field
+extern uint8_t                  formfocus (MCURSES_FORM *, uint16_t);               // move focus to field, if current field is valid
+extern uint16_t                 formvalidate (MCURSES_FORM *);                      // validate all fields, return first invalid
+extern uint8_t                  formkey (MCURSES_FORM *, uint8_t);                  // handle key, TRUE if handled
+extern void                     formtouch (MCURSES_FORM *);                         // screen has been cleared, redraw all
+extern void                     formdraw (MCURSES_FORM *);                          // draw changed fields, refresh() by caller
+
+#endif // MCURSES_FORM_H
@@ -0,0 +1,332 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-gauge.c - gauges and sparklines for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-gauge.h"
+
+static const uint8_t mcurses_spark_chars[6] = { ' ', ACS_S9, ACS_S7, ACS_S5, ACS_S3, ACS_S1 };   // empty, lowest ... highest scan line
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: output character n times
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_gauge_fill (uint8_t ch, uint8_t n)
+{
+    while (n--)
+    {
+        addch (ch);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: create gauge of width cells (max. 254) at line y, column x of window, max is the value of the full bar
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_GAUGE *
+newgauge (WINDOW * win, uint8_t y, uint8_t x, uint8_t width, uint16_t max)
+{
+    MCURSES_GAUGE * g;
+
+    g = calloc (1, sizeof (MCURSES_GAUGE));
+
+    if (g)
+    {
+        g->win          = win;
+        g->y            = y;
+        g->x            = x;
+        g->width        = (width < GAUGE_NONE) ? width : GAUGE_NONE - 1;
+        g->max          = max;
+        g->ch           = ' ';
+        g->attr         = A_REVERSE;
+        g->drawn_len    = GAUGE_NONE;
+    }
+    return g;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: delete gauge, the contents of the window remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delgauge (MCURSES_GAUGE * g)
+{
+    free (g);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: set character and attribute of bar
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gaugestyle (MCURSES_GAUGE * g, uint8_t ch, uint16_t attr)
+{
+    g->ch           = ch;
+    g->attr         = attr;
+    g->drawn_len    = GAUGE_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: add threshold: from value on the bar gets attribute attr. Thresholds must be added in ascending order.
+ * Returns ERR if there are already GAUGE_LEVELS thresholds.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+gaugelevel (MCURSES_GAUGE * g, uint16_t value, uint16_t attr)
+{
+    if (g->nlevels == GAUGE_LEVELS)
+    {
+        return ERR;
+    }
+
+    g->level_value[g->nlevels]  = value;
+    g->level_attr[g->nlevels]   = attr;
+    g->nlevels++;
+    g->drawn_len                = GAUGE_NONE;
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: set value, values above max show a full bar
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gaugeset (MCURSES_GAUGE * g, uint16_t value)
+{
+    g->value = value;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: screen has been cleared, the next gaugedraw() draws the whole bar
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gaugetouch (MCURSES_GAUGE * g)
+{
+    g->drawn_len = GAUGE_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GAUGE: draw changed cells into window, they appear with the next refresh() of the caller
+ *
+ * Only the cells between the old and the new end of the bar are drawn. If the value crosses a threshold, the whole bar
+ * is drawn in its new attribute. Empty cells are drawn as spaces with A_NORMAL, which remains set.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gaugedraw (MCURSES_GAUGE * g)
+{
+    uint16_t    attr    = g->attr;
+    uint8_t     len     = g->width;
+    uint8_t     i;
+
+    if (g->value < g->max)
+    {
+        len = (uint32_t) g->value * g->width / g->max;
+    }
+
+    for (i = 0; i < g->nlevels && g->value >= g->level_value[i]; i++)
+    {
+        attr = g->level_attr[i];
+    }
+
+    if (g->drawn_len == GAUGE_NONE || attr != g->drawn_attr)
+    {
+        (void) wmove (g->win, g->y, g->x);
+        attrset (attr);
+        mcurses_gauge_fill (g->ch, len);
+        attrset (A_NORMAL);
+        mcurses_gauge_fill (' ', g->width - len);
+    }
+    else if (len > g->drawn_len)                                                // bar grows
+    {
+        (void) wmove (g->win, g->y, g->x + g->drawn_len);
+        attrset (attr);
+        mcurses_gauge_fill (g->ch, len - g->drawn_len);
+        attrset (A_NORMAL);
+    }
+    else if (len < g->drawn_len)                                                // bar shrinks
+    {
+        (void) wmove (g->win, g->y, g->x + len);
+        attrset (A_NORMAL);
+        mcurses_gauge_fill (' ', g->drawn_len - len);
+    }
+
+    g->drawn_len    = len;
+    g->drawn_attr   = attr;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: create sparkline of width cells at line y, column x of window. Values from min to max are shown by five
+ * scan line characters. Returns NULL if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_SPARKLINE *
+newsparkline (WINDOW * win, uint8_t y, uint8_t x, uint8_t width, int16_t min, int16_t max)
+{
+    MCURSES_SPARKLINE * s;
+
+    s = calloc (1, sizeof (MCURSES_SPARKLINE));
+
+    if (s)
+    {
+        s->level = calloc (1, width);
+        s->drawn = malloc (width);
+
+        if (! s->level || ! s->drawn)
+        {
+            delsparkline (s);
+            return (MCURSES_SPARKLINE *) 0;
+        }
+
+        s->win      = win;
+        s->y        = y;
+        s->x        = x;
+        s->width    = width;
+        s->min      = min;
+        s->max      = max;
+        s->attr     = A_NORMAL;
+        memset (s->drawn, GAUGE_NONE, width);
+    }
+    return s;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: delete sparkline, the contents of the window remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delsparkline (MCURSES_SPARKLINE * s)
+{
+    free (s->level);
+    free (s->drawn);
+    free (s);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: set attribute
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+sparkattrset (MCURSES_SPARKLINE * s, uint16_t attr)
+{
+    s->attr = attr;
+    sparktouch (s);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: flag = TRUE: a new value overwrites the oldest one and the next cell is left empty, like the beam of an
+ * oscilloscope, so every value costs two cells. flag = FALSE (default): the history shifts left, new values appear
+ * on the right.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+sparksweep (MCURSES_SPARKLINE * s, uint8_t flag)
+{
+    s->sweep    = flag;
+    s->head     = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: add value
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+sparkadd (MCURSES_SPARKLINE * s, int16_t value)
+{
+    int32_t     range   = (int32_t) s->max - s->min;
+    uint8_t     lvl     = 1;
+
+    if (s->width == 0)
+    {
+        return;
+    }
+
+    if (value >= s->max)
+    {
+        lvl = 5;
+    }
+    else if (value > s->min)
+    {
+        lvl = 1 + (((int32_t) value - s->min) * 4 + range / 2) / range;         // rounded to nearest scan line
+    }
+
+    if (s->sweep)
+    {
+        s->level[s->head] = lvl;
+
+        if (++s->head == s->width)
+        {
+            s->head = 0;
+        }
+
+        if (s->width > 1)
+        {
+            s->level[s->head] = 0;                                              // gap in front of beam
+        }
+    }
+    else
+    {
+        memmove (s->level, s->level + 1, s->width - 1);
+        s->level[s->width - 1] = lvl;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: screen has been cleared, the next sparkdraw() draws all cells
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+sparktouch (MCURSES_SPARKLINE * s)
+{
+    memset (s->drawn, GAUGE_NONE, s->width);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPARKLINE: draw changed cells into window, caller has to call refresh()
+ *
+ * Only cells whose scan line differs from the screen are drawn. Afterwards A_NORMAL is set, if something was drawn.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+sparkdraw (MCURSES_SPARKLINE * s)
+{
+    uint8_t     next    = GAUGE_NONE;                                           // cell the cursor stands on
+    uint8_t     i;
+
+    for (i = 0; i < s->width; i++)
+    {
+        if (s->level[i] != s->drawn[i])
+        {
+            if (next == GAUGE_NONE)
+            {
+                attrset (s->attr);
+            }
+
+            if (i != next)
+            {
+                (void) wmove (s->win, s->y, s->x + i);
+            }
+
+            addch (mcurses_spark_chars[s->level[i]]);
+            s->drawn[i] = s->level[i];
+            next = i + 1;
+        }
+    }
+
+    if (next != GAUGE_NONE)
+    {
+        attrset (A_NORMAL);
+    }
+}
@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-gauge.h - include file for mcurses gauges and sparklines
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_GAUGE_H
+#define MCURSES_GAUGE_H
+
+#include "mcurses.h"
+
+#define GAUGE_LEVELS            4                                                   // max. number of thresholds of a gauge
+#define GAUGE_NONE              0xFF                                                // not drawn yet
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * gauge: horizontal bar of width cells showing value 0...max, see newgauge()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of gauge
+    uint8_t             y;                                                          // line in window
+    uint8_t             x;                                                          // column in window
+    uint8_t             width;                                                      // width in cells
+    uint8_t             ch;                                                         // character of bar
+    uint16_t            attr;                                                       // attribute of bar below first threshold
+    uint16_t            max;                                                        // value of full bar
+    uint16_t            value;                                                      // current value
+    uint8_t             nlevels;                                                    // number of thresholds
+    uint16_t            level_value[GAUGE_LEVELS];                                  // thresholds, ascending ...
+    uint16_t            level_attr[GAUGE_LEVELS];                                   // ... and attributes of bar from there on
+    uint8_t             drawn_len;                                                  // length of bar on screen or GAUGE_NONE
+    uint16_t            drawn_attr;                                                 // attribute of bar on screen
+} MCURSES_GAUGE;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * sparkline: history of the last width values in one line, see newsparkline()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of sparkline
+    uint8_t             y;                                                          // line in window
+    uint8_t             x;                                                          // column in window
+    uint8_t             width;                                                      // width in cells
+    uint8_t             sweep;                                                      // TRUE: overwrite at head instead of shifting
+    uint8_t             head;                                                       // sweep: cell of next value
+    int16_t             min;                                                        // value of lowest ...
+    int16_t             max;                                                        // ... and highest scan line
+    uint16_t            attr;                                                       // attribute of sparkline
+    uint8_t *           level;                                                      // level of each cell: 0 = empty, 1-5 = scan line
+    uint8_t *           drawn;                                                      // level of each cell on screen
+} MCURSES_SPARKLINE;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * gauge functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_GAUGE *          newgauge (WINDOW *, uint8_t, uint8_t, uint8_t, uint16_t);  // create gauge: line, column, width, max
+extern void                     delgauge (MCURSES_GAUGE *);                         // delete gauge, contents of window remain
+extern void                     gaugestyle (MCURSES_GAUGE *, uint8_t, uint16_t);    // set character and attribute of bar
+extern uint8_t                  gaugelevel (MCURSES_GAUGE *, uint16_t, uint16_t);   // add threshold: attribute of bar from value on
+extern void                     gaugeset (MCURSES_GAUGE *, uint16_t);               // set value
+extern void                     gaugetouch (MCURSES_GAUGE *);                       // screen has been cleared, redraw all
+extern void                     gaugedraw (MCURSES_GAUGE *);                        // draw changed cells, caller calls refresh()
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * sparkline functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_SPARKLINE *      newsparkline (WINDOW *, uint8_t, uint8_t, uint8_t, int16_t, int16_t);  // create sparkline: line, column, width, min, max
+extern void                     delsparkline (MCURSES_SPARKLINE *);                 // delete sparkline, contents of window remain
+extern void                     sparkattrset (MCURSES_SPARKLINE *, uint16_t);       // set attribute
+extern void                     sparksweep (MCURSES_SPARKLINE *, uint8_t);          // TRUE: overwrite oldest value instead of shifting
+extern void                     sparkadd (MCURSES_SPARKLINE *, int16_t);            // add value
+extern void                     sparktouch (MCURSES_SPARKLINE *);                   // screen has been cleared, redraw all
+extern void                     sparkdraw (MCURSES_SPARKLINE *);                    // draw changed cells, caller calls refresh()
+
+#endif // MCURSES_GAUGE_H
@@ -0,0 +1,446 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-grid.c - table/grid for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-grid.h"
+
+#define DIRTY_BYTES(g)                          (((g)->win->maxx + 7) / 8)      // bytes of dirty bitmap per line
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return row shown in line y of window with given top row, GRID_NONE if none
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_grid_row (MCURSES_GRID * g, uint8_t y, uint32_t top)
+{
+    uint32_t    row = (y < g->hrows) ? y : top + (y - g->hrows);
+
+    return (row < g->nrows) ? row : GRID_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: compute visible columns: header columns, then columns from left on, until the window is full
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_grid_layout (MCURSES_GRID * g)
+{
+    uint16_t    x = 0;
+    uint16_t    col;
+
+    g->nvis = 0;
+
+    for (col = 0; col < g->ncols && x < g->win->maxx; col++)
+    {
+        if (col == g->hcols && g->left > col)                                   // skip columns scrolled out
+        {
+            col = g->left;
+
+            if (col >= g->ncols)
+            {
+                break;
+            }
+        }
+
+        if (g->widths[col] > 0)
+        {
+            g->vis_col[g->nvis] = col;
+            g->vis_x[g->nvis]   = x;
+            g->nvis++;
+            x += g->widths[col];
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: format and draw visible column k of line y, the last column is clipped at the right edge of the window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_grid_drawcell (MCURSES_GRID * g, uint8_t y, uint8_t k, uint32_t top)
+{
+    uint32_t    row     = mcurses_grid_row (g, y, top);
+    uint16_t    col     = g->vis_col[k];
+    uint8_t     w       = g->widths[col];
+    uint16_t    attr    = (row < g->hrows || col < g->hcols) ? g->hdr_attr : g->attr;
+    uint16_t    size;
+    char *      p;
+    uint8_t     width;
+    int16_t     n;
+
+    if (w > g->win->maxx - g->vis_x[k])
+    {
+        w = g->win->maxx - g->vis_x[k];
+    }
+
+    size        = (uint16_t) w * CHAR_BYTES + 1;                                // callback's size is 8 bits
+    g->buf[0]   = '\0';
+
+    if (row != GRID_NONE)
+    {
+        (*g->func) (row, col, g->buf, (size < 0xFF) ? size : 0xFF, &attr, g->data);
+    }
+
+    for (p = g->buf; *p; p++)                                                   // control characters become spaces
+    {
+        if ((uint8_t) *p < ' ')
+        {
+            *p = ' ';
+        }
+    }
+
+    n = strfit (g->buf, -1, w, &width);                                         // clip by display width
+    attrset (attr);
+    (void) wmove (g->win, y, g->vis_x[k]);
+    addnstr (g->buf, n);
+
+    while (width++ < w)                                                         // pad with spaces
+    {
+        addch (' ');
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw all visible columns of line y, clear the rest of the line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_grid_drawline (MCURSES_GRID * g, uint8_t y)
+{
+    uint8_t     k;
+    uint16_t    x = 0;
+
+    for (k = 0; k < g->nvis; k++)
+    {
+        mcurses_grid_drawcell (g, y, k, g->top);
+    }
+
+    if (g->nvis > 0)
+    {
+        x = g->vis_x[g->nvis - 1] + g->widths[g->vis_col[g->nvis - 1]];
+    }
+
+    if (x < g->win->maxx)
+    {
+        attrset (g->attr);
+        (void) wmove (g->win, y, x);
+        wclrtoeol (g->win);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: keep top and left in range
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_grid_clamp (MCURSES_GRID * g)
+{
+    uint8_t     body    = (g->win->maxy > g->hrows) ? g->win->maxy - g->hrows : 0;
+    uint32_t    maxtop  = (g->nrows > g->hrows + body) ? g->nrows - body : g->hrows;
+
+    if (g->top > maxtop)
+    {
+        g->top = maxtop;
+    }
+
+    if (g->top < g->hrows)
+    {
+        g->top = g->hrows;
+    }
+
+    if (g->left >= g->ncols)
+    {
+        g->left = (g->ncols > 0) ? g->ncols - 1 : 0;
+    }
+
+    if (g->left < g->hcols)
+    {
+        g->left = g->hcols;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: create grid of nrows x ncols cells in window, widths[] holds the width of each column (0 = hidden), func formats
+ * a cell. Returns NULL if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_GRID *
+newgrid (WINDOW * win, uint32_t nrows, uint16_t ncols, const uint8_t * widths, MCURSES_GRID_FUNC func, void * data)
+{
+    MCURSES_GRID *  g;
+
+    g = calloc (1, sizeof (MCURSES_GRID));
+
+    if (g)
+    {
+        g->win      = win;
+        g->widths   = malloc (ncols);
+        g->buf      = malloc ((uint16_t) win->maxx * CHAR_BYTES + 1);
+        g->vis_col  = malloc (win->maxx * sizeof (uint16_t));
+        g->vis_x    = malloc (win->maxx);
+        g->dirty    = calloc (win->maxy, DIRTY_BYTES (g));
+
+        if (! g->widths || ! g->buf || ! g->vis_col || ! g->vis_x || ! g->dirty)
+        {
+            delgrid (g);
+            return (MCURSES_GRID *) 0;
+        }
+
+        memcpy (g->widths, widths, ncols);
+        g->func         = func;
+        g->data         = data;
+        g->nrows        = nrows;
+        g->ncols        = ncols;
+        g->drawn_top    = GRID_NONE;
+        g->attr         = A_NORMAL;
+        g->hdr_attr     = A_REVERSE;
+    }
+    return g;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: delete grid, the window and its contents remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delgrid (MCURSES_GRID * g)
+{
+    free (g->widths);
+    free (g->buf);
+    free (g->vis_col);
+    free (g->vis_x);
+    free (g->dirty);
+    free (g);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: set number of fixed header rows (top) and header columns (left), they don't scroll
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridfreeze (MCURSES_GRID * g, uint8_t hrows, uint8_t hcols)
+{
+    g->hrows        = hrows;
+    g->hcols        = hcols;
+    g->drawn_top    = GRID_NONE;
+    mcurses_grid_clamp (g);
+
+    if (hrows < g->win->maxy)
+    {
+        (void) wsetscrreg (g->win, hrows, g->win->maxy - 1);                   // only rows below header scroll
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: set attributes of cells and header cells, the cell callback may change them per cell
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridattrset (MCURSES_GRID * g, uint16_t attr, uint16_t hdr_attr)
+{
+    g->attr         = attr;
+    g->hdr_attr     = hdr_attr;
+    g->drawn_top    = GRID_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: set number of rows, all cells are redrawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridsetrows (MCURSES_GRID * g, uint32_t nrows)
+{
+    g->nrows        = nrows;
+    g->drawn_top    = GRID_NONE;
+    mcurses_grid_clamp (g);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: scroll n rows down (n < 0: up) and m columns right (m < 0: left)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridscroll (MCURSES_GRID * g, int32_t n, int16_t m)
+{
+    g->top  = (n < 0 && (uint32_t) -n > g->top) ? 0 : g->top + n;
+    g->left = (m < 0 && (uint16_t) -m > g->left) ? 0 : g->left + m;
+    mcurses_grid_clamp (g);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: cell has changed: the next griddraw() redraws only this cell, if it is visible
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridtouch (MCURSES_GRID * g, uint32_t row, uint16_t col)
+{
+    uint8_t     y;
+    uint8_t     k;
+
+    if (g->drawn_top == GRID_NONE)                                              // everything is redrawn anyway
+    {
+        return;
+    }
+
+    if (row < g->hrows)
+    {
+        y = row;
+    }
+    else if (row >= g->drawn_top && row - g->drawn_top < (uint32_t) (g->win->maxy - g->hrows))
+    {
+        y = g->hrows + (row - g->drawn_top);
+    }
+    else
+    {
+        return;                                                                 // not visible
+    }
+
+    for (k = 0; k < g->nvis; k++)
+    {
+        if (g->vis_col[k] == col)
+        {
+            g->dirty[y * DIRTY_BYTES (g) + k / 8] |= 1 << (k % 8);
+            g->touched = TRUE;
+            break;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: all cells have changed, redraw all
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+gridtouchall (MCURSES_GRID * g)
+{
+    g->drawn_top = GRID_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: handle KEY_DOWN, KEY_UP, KEY_RIGHT, KEY_LEFT, KEY_NPAGE, KEY_PPAGE, KEY_HOME and KEY_END. Returns TRUE if the
+ * key has been handled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+gridkey (MCURSES_GRID * g, uint8_t ch)
+{
+    int32_t     page = (g->win->maxy > g->hrows) ? g->win->maxy - g->hrows : 1;
+
+    switch (ch)
+    {
+        case KEY_DOWN:
+            gridscroll (g, 1, 0);
+            break;
+        case KEY_UP:
+            gridscroll (g, -1, 0);
+            break;
+        case KEY_RIGHT:
+            gridscroll (g, 0, 1);
+            break;
+        case KEY_LEFT:
+            gridscroll (g, 0, -1);
+            break;
+        case KEY_NPAGE:
+            gridscroll (g, page, 0);
+            break;
+        case KEY_PPAGE:
+            gridscroll (g, -page, 0);
+            break;
+        case KEY_HOME:
+            g->top  = 0;
+            g->left = 0;
+            mcurses_grid_clamp (g);
+            break;
+        case KEY_END:
+            g->top  = GRID_NONE;                                                // clamped to last page
+            mcurses_grid_clamp (g);
+            break;
+        default:
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * GRID: draw changed cells into window - no refresh(), the caller does it
+ *
+ * Only visible cells are formatted. Touched cells are drawn at their old position first. If the grid has been scrolled by
+ * less than a page vertically, the rows below the header are scrolled and only the rows scrolled in are drawn. Scrolling
+ * horizontally redraws all visible cells.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+griddraw (MCURSES_GRID * g)
+{
+    WINDOW *    win     = g->win;
+    uint8_t     body    = (win->maxy > g->hrows) ? win->maxy - g->hrows : 0;
+    uint8_t     full    = (g->drawn_top == GRID_NONE || g->drawn_left != g->left);
+    uint8_t *   dp;
+    uint32_t    d;
+    uint8_t     y;
+    uint8_t     k;
+
+    if (g->touched)
+    {
+        if (! full)
+        {
+            for (y = 0; y < win->maxy; y++)
+            {
+                dp = g->dirty + y * DIRTY_BYTES (g);
+
+                for (k = 0; k < g->nvis; k++)
+                {
+                    if (dp[k / 8] & (1 << (k % 8)))
+                    {
+                        mcurses_grid_drawcell (g, y, k, g->drawn_top);
+                    }
+                }
+            }
+        }
+        memset (g->dirty, 0, win->maxy * DIRTY_BYTES (g));
+        g->touched = FALSE;
+    }
+
+    if (! full && g->top != g->drawn_top)
+    {
+        d = (g->top > g->drawn_top) ? g->top - g->drawn_top : g->drawn_top - g->top;
+        attrset (g->attr);                                                      // new lines get background of cells
+
+        if (d < body && wscrl (win, (g->top > g->drawn_top) ? (int16_t) d : -(int16_t) d) == OK)
+        {
+            for (y = 0; y < d; y++)
+            {
+                mcurses_grid_drawline (g, (g->top > g->drawn_top) ? win->maxy - 1 - y : g->hrows + y);
+            }
+        }
+        else
+        {
+            full = TRUE;
+        }
+    }
+
+    if (full)
+    {
+        mcurses_grid_layout (g);
+
+        for (y = 0; y < win->maxy; y++)
+        {
+            mcurses_grid_drawline (g, y);
+        }
+    }
+
+    g->drawn_top    = g->top;
+    g->drawn_left   = g->left;
+    attrset (g->attr);
+}
@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-grid.h - include file for mcurses table/grid
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_GRID_H
+#define MCURSES_GRID_H
+
+#include "mcurses.h"
+
+#define GRID_NONE               0xFFFFFFFF                                          // no row
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * cell callback: write text of cell into buf (size bytes including terminating '\0'), may change *attr
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef void (* MCURSES_GRID_FUNC) (uint32_t row, uint16_t col, char * buf, uint8_t size, uint16_t * attr, void * data);
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * grid: window on a table of cells formatted by a callback, see newgrid()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of grid
+    MCURSES_GRID_FUNC   func;                                                       // cell callback
+    void *              data;                                                       // argument of cell callback
+    uint8_t *           widths;                                                     // width of each column
+    char *              buf;                                                        // cell buffer: maxx * CHAR_BYTES + 1 bytes
+    uint16_t *          vis_col;                                                    // visible columns ...
+    uint8_t *           vis_x;                                                      // ... and their positions in window
+    uint8_t *           dirty;                                                      // changed cells: bit per line and visible column
+    uint32_t            nrows;                                                      // number of rows
+    uint16_t            ncols;                                                      // number of columns
+    uint8_t             hrows;                                                      // fixed header rows
+    uint8_t             hcols;                                                      // fixed header columns
+    uint8_t             nvis;                                                       // number of visible columns
+    uint8_t             touched;                                                    // TRUE: some cells have changed
+    uint32_t            top;                                                        // first visible row below header rows
+    uint16_t            left;                                                       // first visible column right of header columns
+    uint32_t            drawn_top;                                                  // top of last griddraw() or GRID_NONE
+    uint16_t            drawn_left;                                                 // left of last griddraw()
+    uint16_t            attr;                                                       // attribute of cells
+    uint16_t            hdr_attr;                                                   // attribute of header cells
+} MCURSES_GRID;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * grid functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_GRID *           newgrid (WINDOW *, uint32_t, uint16_t, const uint8_t *, MCURSES_GRID_FUNC, void *); // create grid in window
+extern void                     delgrid (MCURSES_GRID *);                           // delete grid, window remains
+extern void                     gridfreeze (MCURSES_GRID *, uint8_t, uint8_t);      // set number of fixed header rows and columns
+extern void                     gridattrset (MCURSES_GRID *, uint16_t, uint16_t);   // set attributes of cells and header cells
+extern void                     gridsetrows (MCURSES_GRID *, uint32_t);             // set number of rows, redraw all
+extern void                     gridscroll (MCURSES_GRID *, int32_t, int16_t);      // scroll n rows down and m columns right
+extern void                     gridtouch (MCURSES_GRID *, uint32_t, uint16_t);     // cell has changed, redraw it
+extern void                     gridtouchall (MCURSES_GRID *);                      // all cells have changed, redraw all
+extern uint8_t                  gridkey (MCURSES_GRID *, uint8_t);                  // handle cursor keys, TRUE if handled
+extern void                     griddraw (MCURSES_GRID *);                          // draw changed cells, without refresh()
+
+#endif // MCURSES_GRID_H
@@ -0,0 +1,412 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-list.c - list/menu for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-list.h"
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: format row into row buffer
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_list_format (MCURSES_LIST * ls, uint32_t row)
+{
+    ls->buf[0] = '\0';
+    (*ls->func) (row, ls->buf, (uint16_t) ls->win->maxx * CHAR_BYTES + 1, ls->data);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw line y of window, the selected row gets its own attribute over the full width
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_list_drawline (MCURSES_LIST * ls, uint8_t y)
+{
+    uint32_t    row = ls->top + y;
+    char *      p;
+    uint8_t     width;
+    int16_t     n;
+
+    if (row < ls->nrows)
+    {
+        mcurses_list_format (ls, row);
+        attrset ((row == ls->sel) ? ls->sel_attr : ls->attr);
+    }
+    else
+    {
+        ls->buf[0] = '\0';
+        attrset (ls->attr);
+    }
+
+    for (p = ls->buf; *p; p++)                                                  // control characters become spaces
+    {
+        if ((uint8_t) *p < ' ')
+        {
+            *p = ' ';
+        }
+    }
+
+    n = strfit (ls->buf, -1, ls->win->maxx, &width);                            // clip by display width
+    (void) wmove (ls->win, y, 0);
+    addnstr (ls->buf, n);
+
+    while (width++ < ls->win->maxx)                                             // pad with spaces: bar of selected row
+    {
+        addch (' ');
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: keep selected row in range and visible
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_list_show (MCURSES_LIST * ls)
+{
+    uint32_t    maxtop = (ls->nrows > ls->win->maxy) ? ls->nrows - ls->win->maxy : 0;
+
+    if (ls->sel >= ls->nrows)
+    {
+        ls->sel = (ls->nrows > 0) ? ls->nrows - 1 : 0;
+    }
+
+    if (ls->top > maxtop)
+    {
+        ls->top = maxtop;
+    }
+
+    if (ls->sel < ls->top)
+    {
+        ls->top = ls->sel;
+    }
+    else if (ls->sel >= ls->top + ls->win->maxy)
+    {
+        ls->top = ls->sel - ls->win->maxy + 1;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: type-to-search: append character to search string and select first matching row
+ *
+ * A row matching the longer string also matches the shorter one, so the search continues at the match of the shorter
+ * string: rows before it are never formatted again. Sorted lists are searched by bisection.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_list_search (MCURSES_LIST * ls, uint8_t ch)
+{
+    uint8_t     len = ls->searchlen + 1;
+    uint32_t    row;
+    uint32_t    lo;
+    uint32_t    hi;
+    uint32_t    mid;
+
+    if (ls->nrows == 0 || ls->searchlen == LIST_SEARCH_LEN || ls->searchlen >= ls->win->maxx)
+    {
+        return;
+    }
+
+    if (ls->searchlen == 0)
+    {
+        ls->found[0] = ls->sel;                                                 // search starts at selected row
+    }
+
+    ls->search[ls->searchlen] = ch;
+
+    if (ls->sorted)
+    {
+        lo = (ls->searchlen > 0) ? ls->found[ls->searchlen] : 0;
+        hi = ls->nrows;
+
+        while (lo < hi)                                                         // first row >= search string
+        {
+            mid = lo + (hi - lo) / 2;
+            mcurses_list_format (ls, mid);
+
+            if (strncmp (ls->buf, ls->search, len) < 0)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        if (lo == ls->nrows)
+        {
+            return;
+        }
+
+        mcurses_list_format (ls, lo);
+
+        if (strncmp (ls->buf, ls->search, len) != 0)
+        {
+            return;
+        }
+        row = lo;
+    }
+    else
+    {
+        row = (ls->searchlen > 0) ? ls->found[ls->searchlen] : ls->sel;
+
+        for (;;)                                                                // wrap around, stop at start of search
+        {
+            mcurses_list_format (ls, row);
+
+            if (strncmp (ls->buf, ls->search, len) == 0)
+            {
+                break;
+            }
+
+            if (++row == ls->nrows)
+            {
+                row = 0;
+            }
+
+            if (row == ls->found[0])
+            {
+                return;                                                         // not found: ignore character
+            }
+        }
+    }
+
+    ls->searchlen = len;
+    ls->found[len] = row;
+    ls->sel = row;
+    mcurses_list_show (ls);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: create list of nrows rows in window, func formats a row
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_LIST *
+newlist (WINDOW * win, uint32_t nrows, MCURSES_LIST_FUNC func, void * data)
+{
+    MCURSES_LIST *  ls;
+
+    ls = calloc (1, sizeof (MCURSES_LIST));
+
+    if (ls)
+    {
+        ls->buf = malloc ((uint16_t) win->maxx * CHAR_BYTES + 1);
+
+        if (! ls->buf)
+        {
+            free (ls);
+            return (MCURSES_LIST *) 0;
+        }
+
+        ls->win         = win;
+        ls->func        = func;
+        ls->data        = data;
+        ls->nrows       = nrows;
+        ls->drawn_top   = LIST_NONE;
+        ls->attr        = A_NORMAL;
+        ls->sel_attr    = A_REVERSE;
+    }
+    return ls;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: delete list, the window and its contents remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+dellist (MCURSES_LIST * ls)
+{
+    free (ls->buf);
+    free (ls);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: set attributes of rows and of selected row
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listattrset (MCURSES_LIST * ls, uint16_t attr, uint16_t sel_attr)
+{
+    ls->attr        = attr;
+    ls->sel_attr    = sel_attr;
+    ls->drawn_top   = LIST_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: rows are sorted by strcmp() of their text: type-to-search uses bisection
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listsorted (MCURSES_LIST * ls, uint8_t flag)
+{
+    ls->sorted      = flag;
+    ls->searchlen   = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: set number of rows, all rows are redrawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listsetrows (MCURSES_LIST * ls, uint32_t nrows)
+{
+    ls->nrows       = nrows;
+    ls->searchlen   = 0;
+    ls->drawn_top   = LIST_NONE;
+    mcurses_list_show (ls);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: contents of rows have changed, all rows are redrawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listtouch (MCURSES_LIST * ls)
+{
+    ls->drawn_top = LIST_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: select row, scroll if necessary
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listselect (MCURSES_LIST * ls, uint32_t row)
+{
+    ls->sel         = row;
+    ls->searchlen   = 0;
+    mcurses_list_show (ls);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: return selected row, LIST_NONE if list is empty
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint32_t
+listselected (MCURSES_LIST * ls)
+{
+    return (ls->nrows > 0) ? ls->sel : LIST_NONE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: handle key: cursor keys move selection, printable characters search, KEY_BACKSPACE and KEY_ESCAPE edit search.
+ * Returns TRUE if the key has been handled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+listkey (MCURSES_LIST * ls, uint8_t ch)
+{
+    uint8_t     page = ls->win->maxy;
+
+    switch (ch)
+    {
+        case KEY_DOWN:
+            listselect (ls, ls->sel + 1);
+            break;
+        case KEY_UP:
+            listselect (ls, (ls->sel > 0) ? ls->sel - 1 : 0);
+            break;
+        case KEY_NPAGE:
+            ls->top += page;
+            listselect (ls, (ls->nrows > page && ls->sel < ls->nrows - page) ? ls->sel + page : ls->nrows - 1);
+            break;
+        case KEY_PPAGE:
+            ls->top = (ls->top > page) ? ls->top - page : 0;
+            listselect (ls, (ls->sel > page) ? ls->sel - page : 0);
+            break;
+        case KEY_HOME:
+            listselect (ls, 0);
+            break;
+        case KEY_END:
+            listselect (ls, ls->nrows - 1);
+            break;
+        case KEY_BACKSPACE:
+            if (ls->searchlen > 0)                                              // back to match of shorter string
+            {
+                ls->searchlen--;
+                ls->sel = ls->found[ls->searchlen];
+                mcurses_list_show (ls);
+            }
+            break;
+        case KEY_ESCAPE:
+            ls->searchlen = 0;
+            break;
+        default:
+            if (ch < ' ' || ch >= 0x7F)
+            {
+                return FALSE;
+            }
+            mcurses_list_search (ls, ch);
+            break;
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LIST: draw changed rows into window, refresh() is left to the caller
+ *
+ * Only visible rows are formatted. If the list has been scrolled by less than a page, the window is scrolled and only the
+ * rows scrolled in are formatted, plus the rows losing and getting the selection. The attribute of rows remains set.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+listdraw (MCURSES_LIST * ls)
+{
+    WINDOW *    win = ls->win;
+    uint32_t    d;
+    uint8_t     y;
+
+    if (ls->drawn_top != LIST_NONE && ls->drawn_top != ls->top)
+    {
+        d = (ls->top > ls->drawn_top) ? ls->top - ls->drawn_top : ls->drawn_top - ls->top;
+        attrset (ls->attr);                                                     // new lines get background of rows
+
+        if (d < win->maxy && wscrl (win, (ls->top > ls->drawn_top) ? (int16_t) d : -(int16_t) d) == OK)
+        {
+            for (y = 0; y < d; y++)
+            {
+                mcurses_list_drawline (ls, (ls->top > ls->drawn_top) ? win->maxy - 1 - y : y);
+            }
+        }
+        else
+        {
+            ls->drawn_top = LIST_NONE;
+        }
+    }
+
+    if (ls->drawn_top == LIST_NONE)
+    {
+        for (y = 0; y < win->maxy; y++)
+        {
+            mcurses_list_drawline (ls, y);
+        }
+    }
+    else if (ls->drawn_sel != ls->sel)
+    {
+        if (ls->drawn_sel >= ls->top && ls->drawn_sel < ls->top + win->maxy)
+        {
+            mcurses_list_drawline (ls, ls->drawn_sel - ls->top);
+        }
+
+        if (ls->sel >= ls->top && ls->sel < ls->top + win->maxy)
+        {
+            mcurses_list_drawline (ls, ls->sel - ls->top);
+        }
+    }
+
+    ls->drawn_top = ls->top;
+    ls->drawn_sel = ls->sel;
+    attrset (ls->attr);
+    (void) wmove (win, ls->sel - ls->top, 0);
+}
@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-list.h - include file for mcurses list/menu
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_LIST_H
+#define MCURSES_LIST_H
+
+#include "mcurses.h"
+
+#define LIST_SEARCH_LEN         32                                                  // max. length of type-to-search string
+#define LIST_NONE               0xFFFFFFFF                                          // no row
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * row callback: write text of row into buf (size bytes including terminating '\0')
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef void (* MCURSES_LIST_FUNC) (uint32_t row, char * buf, uint16_t size, void * data);
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * list: window on rows formatted by a callback, see newlist()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *            win;                                                        // window of list
+    MCURSES_LIST_FUNC   func;                                                       // row callback
+    void *              data;                                                       // argument of row callback
+    char *              buf;                                                        // row buffer: maxx * CHAR_BYTES + 1 bytes
+    uint32_t            nrows;                                                      // number of rows
+    uint32_t            top;                                                        // first visible row
+    uint32_t            sel;                                                        // selected row
+    uint32_t            drawn_top;                                                  // top row of last listdraw() or LIST_NONE
+    uint32_t            drawn_sel;                                                  // selected row of last listdraw()
+    uint16_t            attr;                                                       // attribute of rows
+    uint16_t            sel_attr;                                                   // attribute of selected row
+    uint8_t             sorted;                                                     // TRUE: rows are sorted, search by bisection
+    uint8_t             searchlen;                                                  // length of search string
+    char                search[LIST_SEARCH_LEN];                                    // search string typed so far
+    uint32_t            found[LIST_SEARCH_LEN + 1];                                 // found[n]: match of first n characters
+} MCURSES_LIST;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * list functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_LIST *           newlist (WINDOW *, uint32_t, MCURSES_LIST_FUNC, void *);   // create list in window
+extern void                     dellist (MCURSES_LIST *);                           // delete list, window remains
+extern void                     listattrset (MCURSES_LIST *, uint16_t, uint16_t);   // set attributes of rows and selected row
+extern void                     listsorted (MCURSES_LIST *, uint8_t);               // rows are sorted: bisection search
+extern void                     listsetrows (MCURSES_LIST *, uint32_t);             // set number of rows, redraw all
+extern void                     listtouch (MCURSES_LIST *);                         // rows have changed, redraw all
+extern void                     listselect (MCURSES_LIST *, uint32_t);              // select row, scroll if necessary
+extern uint32_t                 listselected (MCURSES_LIST *);                      // return selected row or LIST_NONE
+extern uint8_t                  listkey (MCURSES_LIST *, uint8_t);                  // handle key, TRUE if handled
+extern void                     listdraw (MCURSES_LIST *);                          // draw changed rows, caller calls refresh()
+
+#endif // MCURSES_LIST_H
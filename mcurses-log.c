@@ -0,0 +1,159 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-log.c - log window for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-log.h"
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LOG: create log in window, the ring buffer holds one page
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_LOG *
+newlog (WINDOW * win)
+{
+    MCURSES_LOG *   log;
+
+    log = malloc (sizeof (MCURSES_LOG));
+
+    if (log)
+    {
+        log->win    = win;
+        log->buf    = malloc ((uint16_t) win->maxy * win->maxx * CHAR_BYTES);
+        log->len    = calloc (win->maxy, sizeof (uint16_t));
+        log->head   = 0;
+        log->added  = 0;
+
+        if (! log->buf || ! log->len)
+        {
+            dellog (log);
+            return (MCURSES_LOG *) 0;
+        }
+
+        (void) wsetscrreg (win, 0, win->maxy - 1);                              // log scrolls the whole window
+    }
+    return log;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LOG: delete log, the window and its contents remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+dellog (MCURSES_LOG * log)
+{
+    free (log->buf);
+    free (log->len);
+    free (log);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LOG: append line with len bytes, nothing is drawn. Lines are cut at the right edge of the window by display width,
+ * control characters become spaces. If more lines than the window holds are appended, the oldest are overwritten.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+lognaddstr (MCURSES_LOG * log, const char * str, uint16_t len)
+{
+    WINDOW *    win = log->win;
+    char *      p   = log->buf + (uint16_t) log->head * win->maxx * CHAR_BYTES;
+    uint16_t    i;
+
+    if (len > (uint16_t) win->maxx * CHAR_BYTES)
+    {
+        len = (uint16_t) win->maxx * CHAR_BYTES;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        p[i] = ((uint8_t) str[i] < ' ') ? ' ' : str[i];
+    }
+
+    log->len[log->head] = strfit (p, len, win->maxx, (uint8_t *) 0);
+
+    if (++log->head == win->maxy)
+    {
+        log->head = 0;
+    }
+
+    if (log->added < win->maxy)
+    {
+        log->added++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LOG: append line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+logaddstr (MCURSES_LOG * log, const char * str)
+{
+    lognaddstr (log, str, strlen (str));
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * LOG: put lines appended since last call into window, the caller shows them with refresh()
+ *
+ * The window is scrolled by the number of new lines and only these are drawn. If the window can't be scrolled, all lines
+ * are redrawn. The cursor is left behind the last line: if it stays there until the next refresh(), the terminal scrolls
+ * by LFs on the bottom margin.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+logdraw (MCURSES_LOG * log)
+{
+    WINDOW *    win     = log->win;
+    uint8_t     k       = log->added;
+    uint8_t     redraw  = FALSE;
+    uint8_t     idx;
+    uint8_t     width   = 0;
+    uint8_t     i;
+    char *      p;
+
+    if (k == 0)
+    {
+        return;
+    }
+
+    if (wscrl (win, k) == ERR)                                                  // window can't be scrolled: redraw it
+    {
+        k = win->maxy;
+        redraw = TRUE;
+    }
+
+    idx = (log->head + win->maxy - k) % win->maxy;                              // oldest new line
+
+    for (i = win->maxy - k; i < win->maxy; i++)
+    {
+        p   = log->buf + (uint16_t) idx * win->maxx * CHAR_BYTES;
+
+        (void) strfit (p, log->len[idx], win->maxx, &width);
+        (void) wmove (win, i, 0);
+        addnstr (p, log->len[idx]);                                             // line fits: no wrap
+
+        if (redraw && width < win->maxx)
+        {
+            win->curx = width;
+            wclrtoeol (win);
+        }
+
+        if (++idx == win->maxy)
+        {
+            idx = 0;
+        }
+    }
+
+    log->added = 0;
+    (void) wmove (win, win->maxy - 1, (width < win->maxx) ? width : win->maxx - 1);
+}
@@ -0,0 +1,41 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-log.h - include file for mcurses log window
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_LOG_H
+#define MCURSES_LOG_H
+
+#include "mcurses.h"
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * log window: ring buffer of the last lines, see newlog()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *    win;                                                                // window of log
+    char *      buf;                                                                // ring buffer: maxy lines of maxx * CHAR_BYTES bytes
+    uint16_t *  len;                                                                // length of each line in ring buffer in bytes
+    uint8_t     head;                                                               // index of next line in ring buffer
+    uint8_t     added;                                                              // lines added since last logdraw(), max. maxy
+} MCURSES_LOG;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * log functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_LOG *            newlog (WINDOW *);                                  // create log in window
+extern void                     dellog (MCURSES_LOG *);                             // delete log, window remains
+extern void                     lognaddstr (MCURSES_LOG *, const char *, uint16_t); // append line with length
+extern void                     logaddstr (MCURSES_LOG *, const char *);            // append line
+extern void                     logdraw (MCURSES_LOG *);                            // put new lines into window, caller refreshes
+
+#endif // MCURSES_LOG_H
@@ -0,0 +1,473 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-pager.c - pager for mcurses lib (UNIX only)
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mcurses-pager.h"
+
+#define PAGER_JUMP                              0x7FFFFFFF                      // shift: position jumped, redraw page
+
+#if MCURSES_UTF8                                                                // byte of text, no control character
+#define IS_TEXT(ch)                             ((ch) >= ' ' && (ch) != 0x7F)   // bytes >= 0x80 belong to UTF-8 sequences
+#else
+#define IS_TEXT(ch)                             ((ch) >= ' ' && ((ch) < 0x7F || (ch) >= 0xA0))   // 0x80-0x9F: ACS range
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return offset of line following the line at offset off, size of file if there is none
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static size_t
+mcurses_pager_next (MCURSES_PAGER * pg, size_t off)
+{
+    const char *    p;
+
+    if (off >= pg->size)
+    {
+        return pg->size;
+    }
+
+    p = memchr (pg->data + off, '\n', pg->size - off);
+    return p ? (size_t) (p - pg->data) + 1 : pg->size;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return offset of line preceding the line at offset off
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static size_t
+mcurses_pager_prev (MCURSES_PAGER * pg, size_t off)
+{
+    if (off > 0)
+    {
+        off--;                                                                  // newline of previous line
+
+        while (off > 0 && pg->data[off - 1] != '\n')
+        {
+            off--;
+        }
+    }
+    return off;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: extend index until line number line or offset off is reached. Only every MCURSES_PAGER_STEP-th line is stored.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_pager_index (MCURSES_PAGER * pg, uint32_t line, size_t off)
+{
+    size_t *    index;
+    size_t      next;
+
+    while (pg->idx_line < line && pg->idx_off < off)
+    {
+        next = mcurses_pager_next (pg, pg->idx_off);
+
+        if (next >= pg->size)                                                   // idx_line is the last line
+        {
+            break;
+        }
+
+        if ((pg->idx_line + 1) % MCURSES_PAGER_STEP == 0)
+        {
+            if (pg->nindex == pg->maxindex)
+            {
+                index = realloc (pg->index, 2 * pg->maxindex * sizeof (size_t));
+
+                if (! index)
+                {
+                    break;                                                      // no memory: index stays as it is
+                }
+                pg->index = index;
+                pg->maxindex *= 2;
+            }
+            pg->index[pg->nindex++] = next;
+        }
+
+        pg->idx_off = next;
+        pg->idx_line++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: map file and create pager in window. Returns NULL if the file can't be mapped or there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_PAGER *
+newpager (WINDOW * win, const char * filename)
+{
+    MCURSES_PAGER * pg;
+    struct stat     st;
+    uint8_t         y;
+    int             fd;
+
+    fd = open (filename, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return (MCURSES_PAGER *) 0;
+    }
+
+    pg = calloc (1, sizeof (MCURSES_PAGER));
+
+    if (pg && fstat (fd, &st) == 0)
+    {
+        pg->size        = st.st_size;
+        pg->maxindex    = 64;
+        pg->index       = malloc (pg->maxindex * sizeof (size_t));
+
+        if (pg->size > 0)
+        {
+            pg->data = mmap (0, pg->size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (pg->data == MAP_FAILED)
+            {
+                pg->data = 0;
+                free (pg->index);
+                pg->index = 0;
+            }
+        }
+    }
+
+    close (fd);                                                                 // the mapping remains
+
+    if (! pg || ! pg->index)
+    {
+        if (pg)
+        {
+            delpager (pg);
+        }
+        return (MCURSES_PAGER *) 0;
+    }
+
+    pg->win         = win;
+    pg->index[0]    = 0;
+    pg->nindex      = 1;
+    pg->shift       = PAGER_JUMP;
+
+    pg->end_off = mcurses_pager_prev (pg, pg->size);                            // last line ...
+
+    for (y = 1; y < win->maxy; y++)                                             // ... and the lines above it
+    {
+        pg->end_off = mcurses_pager_prev (pg, pg->end_off);
+    }
+
+    return pg;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: unmap file and delete pager, the window and its contents remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delpager (MCURSES_PAGER * pg)
+{
+    if (pg->data)
+    {
+        munmap ((void *) pg->data, pg->size);
+    }
+    free (pg->index);
+    free (pg);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: scroll n lines down (n > 0) or -n lines up (n < 0), stops at first and last page
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+pagerscroll (MCURSES_PAGER * pg, int32_t n)
+{
+    uint8_t     indexed = (pg->idx_off >= pg->top_off);
+    int32_t     moved = 0;
+
+    while (moved < n && pg->top_off < pg->end_off)
+    {
+        pg->top_off = mcurses_pager_next (pg, pg->top_off);
+        moved++;
+    }
+
+    while (moved > n && pg->top_off > 0)
+    {
+        pg->top_off = mcurses_pager_prev (pg, pg->top_off);
+        moved--;
+    }
+
+    if (pg->top_line != PAGER_UNKNOWN)
+    {
+        pg->top_line += moved;
+    }
+
+    if (pg->shift != PAGER_JUMP)
+    {
+        pg->shift += moved;
+
+        if (pg->shift >= pg->win->maxy || pg->shift <= -pg->win->maxy)
+        {
+            pg->shift = PAGER_JUMP;
+        }
+    }
+
+    if (indexed)                                                                // index reaches top line: keep it up
+    {
+        mcurses_pager_index (pg, PAGER_UNKNOWN, pg->top_off);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: show line n at top, the index is extended up to line n
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+pagergoto (MCURSES_PAGER * pg, uint32_t line)
+{
+    size_t      off;
+    uint32_t    i;
+
+    mcurses_pager_index (pg, line, pg->size);
+
+    if (line > pg->idx_line)                                                    // behind last line
+    {
+        line = pg->idx_line;
+    }
+
+    off = pg->index[line / MCURSES_PAGER_STEP];
+
+    for (i = line - line % MCURSES_PAGER_STEP; i < line; i++)
+    {
+        off = mcurses_pager_next (pg, off);
+    }
+
+    pg->top_off     = (off < pg->end_off) ? off : pg->end_off;
+    pg->top_line    = PAGER_UNKNOWN;
+    pg->shift       = PAGER_JUMP;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: show last page, the file is not indexed up to there
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+pagerend (MCURSES_PAGER * pg)
+{
+    pg->top_off     = pg->end_off;
+    pg->top_line    = PAGER_UNKNOWN;
+    pg->shift       = PAGER_JUMP;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: search string in the lines below the top line. If found, the line becomes the top line and TRUE is returned.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+pagersearch (MCURSES_PAGER * pg, const char * str)
+{
+    size_t          len = strlen (str);
+    size_t          off;
+    const char *    p;
+
+    if (len == 0 || pg->size == 0)
+    {
+        return FALSE;
+    }
+
+    off = mcurses_pager_next (pg, pg->top_off);
+
+    while (len <= pg->size - off)
+    {
+        p = memchr (pg->data + off, str[0], pg->size - off - len + 1);          // find first character, then compare
+
+        if (! p)
+        {
+            return FALSE;
+        }
+
+        off = p - pg->data;
+
+        if (memcmp (p, str, len) == 0)
+        {
+            break;
+        }
+        off++;
+    }
+
+    if (len > pg->size - off)
+    {
+        return FALSE;
+    }
+
+    while (off > 0 && pg->data[off - 1] != '\n')                                // start of line
+    {
+        off--;
+    }
+
+    if (pg->idx_off >= pg->top_off)                                             // index reaches top line: extend it
+    {
+        mcurses_pager_index (pg, PAGER_UNKNOWN, off);
+    }
+
+    pg->top_off     = (off < pg->end_off) ? off : pg->end_off;
+    pg->top_line    = PAGER_UNKNOWN;
+    pg->shift       = PAGER_JUMP;
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: return number of top line (0 = first line) or PAGER_UNKNOWN if the file is not yet indexed up to there
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint32_t
+pagerline (MCURSES_PAGER * pg)
+{
+    uint32_t    lo;
+    uint32_t    hi;
+    uint32_t    mid;
+    size_t      off;
+
+    if (pg->top_line == PAGER_UNKNOWN && pg->top_off <= pg->idx_off)
+    {
+        lo = 0;                                                                 // find last index entry <= top line
+        hi = pg->nindex - 1;
+
+        while (lo < hi)
+        {
+            mid = (lo + hi + 1) / 2;
+
+            if (pg->index[mid] <= pg->top_off)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+
+        pg->top_line = lo * MCURSES_PAGER_STEP;
+
+        for (off = pg->index[lo]; off < pg->top_off; off = mcurses_pager_next (pg, off))
+        {
+            pg->top_line++;
+        }
+    }
+    return pg->top_line;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: handle KEY_DOWN, KEY_UP, KEY_NPAGE, KEY_PPAGE, KEY_HOME and KEY_END. Returns TRUE if the key has been handled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+pagerkey (MCURSES_PAGER * pg, uint8_t ch)
+{
+    switch (ch)
+    {
+        case KEY_DOWN:  pagerscroll (pg, 1);                break;
+        case KEY_UP:    pagerscroll (pg, -1);               break;
+        case KEY_NPAGE: pagerscroll (pg, pg->win->maxy);    break;
+        case KEY_PPAGE: pagerscroll (pg, -pg->win->maxy);   break;
+        case KEY_HOME:  pagergoto (pg, 0);                  break;
+        case KEY_END:   pagerend (pg);                      break;
+        default:        return FALSE;
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PAGER: draw visible page into window, shown by the next refresh() of the caller
+ *
+ * If the page has been scrolled by less than a page, the window is scrolled first: with the virtual screen refresh()
+ * then sends only the new lines. Tabs are expanded, other control characters are shown as '?'. Text is clipped by
+ * display width, UTF-8 sequences go to the terminal as they are.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+pagerdraw (MCURSES_PAGER * pg)
+{
+    WINDOW *        win = pg->win;
+    size_t          off = pg->top_off;
+    const char *    p;
+    const char *    q;
+    const char *    end = pg->data + pg->size;
+    uint8_t         ch;
+    uint8_t         col;
+    uint8_t         width;
+    int16_t         n;
+    uint8_t         y;
+
+    if (pg->shift != 0 && pg->shift != PAGER_JUMP)
+    {
+        (void) wscrl (win, (int16_t) pg->shift);
+    }
+    pg->shift = 0;
+
+    for (y = 0; y < win->maxy; y++)
+    {
+        (void) wmove (win, y, 0);
+        col = 0;
+
+        if (off < pg->size)
+        {
+            for (p = pg->data + off; p < end && *p != '\n' && col < win->maxx; )
+            {
+                ch = *p;
+
+                if (IS_TEXT (ch))                                               // run of text: clip by display width
+                {
+                    for (q = p + 1; q < end && q < p + (win->maxx - col) * CHAR_BYTES && IS_TEXT ((uint8_t) *q); q++)
+                    {
+                        ;
+                    }
+
+                    n = strfit (p, q - p, win->maxx - col, &width);
+
+                    if (n == 0)                                                 // wide character doesn't fit
+                    {
+                        break;
+                    }
+
+                    addnstr (p, n);
+                    col += width;
+                    p   += n;
+                    continue;
+                }
+
+                if (ch == '\t')
+                {
+                    do
+                    {
+                        addch (' ');
+                        col++;
+                    } while ((col & 7) && col < win->maxx);
+                }
+                else if (ch != '\r')                                            // other control characters
+                {
+                    addch ('?');
+                    col++;
+                }
+                p++;
+            }
+            off = mcurses_pager_next (pg, off);
+        }
+
+        if (col < win->maxx)
+        {
+            win->curx = col;
+            wclrtoeol (win);
+        }
+    }
+}
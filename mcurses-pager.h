@@ -0,0 +1,55 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-pager.h - include file for mcurses pager (UNIX only)
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_PAGER_H
+#define MCURSES_PAGER_H
+
+#include <stddef.h>
+#include "mcurses.h"
+
+#define PAGER_UNKNOWN           0xFFFFFFFF                                          // pagerline(): line number not yet indexed
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * pager: window on a memory mapped file, see newpager()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    WINDOW *        win;                                                            // window of pager
+    const char *    data;                                                           // mapped file
+    size_t          size;                                                           // size of file
+    size_t *        index;                                                          // offset of line n * MCURSES_PAGER_STEP
+    uint32_t        nindex;                                                         // used entries of index
+    uint32_t        maxindex;                                                       // allocated entries of index
+    uint32_t        idx_line;                                                       // lines 0..idx_line are indexed,
+    size_t          idx_off;                                                        // idx_line starts at this offset
+    size_t          top_off;                                                        // offset of top line
+    uint32_t        top_line;                                                       // number of top line or PAGER_UNKNOWN
+    size_t          end_off;                                                        // offset of top line of last page
+    int32_t         shift;                                                          // lines scrolled since last pagerdraw()
+} MCURSES_PAGER;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * pager functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_PAGER *          newpager (WINDOW *, const char *);                  // map file into pager in window
+extern void                     delpager (MCURSES_PAGER *);                         // unmap file, delete pager
+extern void                     pagerscroll (MCURSES_PAGER *, int32_t);             // scroll n lines down (n > 0) or up (n < 0)
+extern void                     pagergoto (MCURSES_PAGER *, uint32_t);              // show line n at top (0 = first line)
+extern void                     pagerend (MCURSES_PAGER *);                         // show last page
+extern uint8_t                  pagersearch (MCURSES_PAGER *, const char *);        // search string below top line
+extern uint32_t                 pagerline (MCURSES_PAGER *);                        // number of top line or PAGER_UNKNOWN
+extern uint8_t                  pagerkey (MCURSES_PAGER *, uint8_t);                // handle cursor keys, TRUE if handled
+extern void                     pagerdraw (MCURSES_PAGER *);                        // draw visible page, refresh() is up to caller
+
+#endif // MCURSES_PAGER_H
@@ -0,0 +1,501 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-panel.c - panels for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-panel.h"
+
+static MCURSES_PANEL *          mcurses_panel_tab[PANEL_MAX];                       // panel of id n is in mcurses_panel_tab[n - 1]
+static MCURSES_PANEL *          mcurses_panel_stack[PANEL_MAX];                     // panels from bottom to top
+static uint8_t                  mcurses_panel_n;                                    // number of panels
+static uint8_t *                mcurses_panel_owner;                                // id of visible panel per screen cell, 0 = none
+static uint16_t                 mcurses_panel_attr;                                 // attribute set by last mcurses_panel_put()
+static uint16_t                 mcurses_panel_caller_attr;                          // attribute of caller, restored at the end
+#if MCURSES_VIRTUAL_SCREEN
+static chtype *                 mcurses_panel_under;                                // screen cells below panels, saved when covered
+#endif
+
+#define OWNER(y,x)              mcurses_panel_owner[(uint16_t) (y) * COLS + (x)]
+#define UNDER(y,x)              mcurses_panel_under[(uint16_t) (y) * COLS + (x)]
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: output character at screen position y, x
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_put (uint8_t y, uint8_t x, uint8_t ch, uint16_t attr)
+{
+    uint8_t     cy;
+    uint8_t     cx;
+
+    getyx (cy, cx);
+
+    if (cy != y || cx != x)
+    {
+        move (y, x);
+    }
+
+    if (attr != mcurses_panel_attr)
+    {
+        attrset (attr);
+        mcurses_panel_attr = attr;
+    }
+    addch (ch);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: begin drawing, remember attribute of caller
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_begin (void)
+{
+    mcurses_panel_caller_attr   = getattrs ();
+    mcurses_panel_attr          = mcurses_panel_caller_attr;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: end drawing, restore attribute of caller
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_end (void)
+{
+    if (mcurses_panel_attr != mcurses_panel_caller_attr)
+    {
+        attrset (mcurses_panel_caller_attr);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: recompute owners of screen cells in rectangle of nlines x ncols at y1, x1, draw cells whose owner has changed
+ * or is panel force
+ *
+ * Every visible panel, from bottom to top, claims its cells in a line of the rectangle, the highest panel wins. Only
+ * cells whose owner differs from the old one are drawn: cells covered by a higher panel before and after are skipped.
+ * With virtual screen, a cell covered by the first panel is saved and restored when no panel covers it any more.
+ * Without, such a cell becomes blank: put a panel below all others to own the background.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_update (uint8_t y1, uint8_t x1, uint8_t nlines, uint8_t ncols, uint8_t force)
+{
+    uint8_t             row[COLS];
+    MCURSES_PANEL *     p;
+    MCURSES_PANEL_CELL *cp;
+    uint8_t             y2;
+    uint8_t             x2;
+    uint8_t             y;
+    uint8_t             x;
+    uint8_t             xa;
+    uint8_t             xb;
+    uint8_t             i;
+
+    if (y1 >= LINES || x1 >= COLS)
+    {
+        return;
+    }
+
+    y2 = (y1 + nlines <= LINES) ? y1 + nlines - 1 : LINES - 1;                  // clip at edge of screen
+    x2 = (x1 + ncols <= COLS) ? x1 + ncols - 1 : COLS - 1;
+
+    mcurses_panel_begin ();
+
+    for (y = y1; y <= y2; y++)
+    {
+        memset (row + x1, 0, x2 - x1 + 1);
+
+        for (i = 0; i < mcurses_panel_n; i++)
+        {
+            p = mcurses_panel_stack[i];
+
+            if (p->hidden || y < p->begy || y >= p->begy + p->maxy)
+            {
+                continue;
+            }
+
+            xa = (p->begx > x1) ? p->begx : x1;
+            xb = (p->begx + p->maxx - 1 < x2) ? p->begx + p->maxx - 1 : x2;
+
+            if (xa <= xb && p->begx + p->maxx > x1)
+            {
+                memset (row + xa, p->id, xb - xa + 1);
+            }
+        }
+
+        for (x = x1; x <= x2; x++)
+        {
+            if (row[x] != OWNER (y, x) || (force && row[x] == force))
+            {
+#if MCURSES_VIRTUAL_SCREEN
+                if (! OWNER (y, x))                                             // cell gets covered: save it
+                {
+                    move (y, x);
+                    (void) inchnstr (&UNDER (y, x), 1);
+                }
+#endif
+                OWNER (y, x) = row[x];
+
+                if (row[x])
+                {
+                    p   = mcurses_panel_tab[row[x] - 1];
+                    cp  = p->cells + (y - p->begy) * p->maxx + (x - p->begx);
+                    mcurses_panel_put (y, x, cp->ch, cp->attr);
+                }
+                else
+                {
+#if MCURSES_VIRTUAL_SCREEN
+                    move (y, x);                                                // no panel here: restore saved cell
+                    addchnstr (&UNDER (y, x), 1);
+#else
+                    mcurses_panel_put (y, x, ' ', A_NORMAL);                    // no panel here
+#endif
+                }
+            }
+        }
+    }
+
+    mcurses_panel_end ();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: update screen cells of panel
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_area (MCURSES_PANEL * p, uint8_t force)
+{
+    mcurses_panel_update (p->begy, p->begx, p->maxy, p->maxx, force);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: remove panel from stack
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_unlink (MCURSES_PANEL * p)
+{
+    uint8_t     i;
+
+    for (i = 0; i < mcurses_panel_n; i++)
+    {
+        if (mcurses_panel_stack[i] == p)
+        {
+            memmove (mcurses_panel_stack + i, mcurses_panel_stack + i + 1, (mcurses_panel_n - i - 1) * sizeof (MCURSES_PANEL *));
+            mcurses_panel_n--;
+            break;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: create panel of nlines lines and ncols columns at line begy, column begx of screen on top of all other panels.
+ * The panel is blank, its cells are drawn at once. Returns NULL if there are already PANEL_MAX panels or no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_PANEL *
+newpanel (uint8_t nlines, uint8_t ncols, uint8_t begy, uint8_t begx)
+{
+    MCURSES_PANEL * p;
+    uint8_t         id;
+
+    for (id = 0; id < PANEL_MAX && mcurses_panel_tab[id]; id++)
+    {
+        ;
+    }
+
+    if (id == PANEL_MAX || nlines == 0 || ncols == 0)
+    {
+        return (MCURSES_PANEL *) 0;
+    }
+
+    if (! mcurses_panel_owner)
+    {
+        mcurses_panel_owner = calloc (LINES, COLS);
+
+        if (! mcurses_panel_owner)
+        {
+            return (MCURSES_PANEL *) 0;
+        }
+
+#if MCURSES_VIRTUAL_SCREEN
+        mcurses_panel_under = malloc ((uint16_t) LINES * COLS * sizeof (chtype));
+
+        if (! mcurses_panel_under)
+        {
+            free (mcurses_panel_owner);
+            mcurses_panel_owner = (uint8_t *) 0;
+            return (MCURSES_PANEL *) 0;
+        }
+#endif
+    }
+
+    p = calloc (1, sizeof (MCURSES_PANEL));
+
+    if (p)
+    {
+        p->cells = malloc ((uint16_t) nlines * ncols * sizeof (MCURSES_PANEL_CELL));
+
+        if (! p->cells)
+        {
+            free (p);
+            return (MCURSES_PANEL *) 0;
+        }
+
+        p->id       = id + 1;
+        p->begy     = begy;
+        p->begx     = begx;
+        p->maxy     = nlines;
+        p->maxx     = ncols;
+        p->attr     = A_NORMAL;
+        mcurses_panel_tab[id] = p;
+        mcurses_panel_stack[mcurses_panel_n++] = p;
+        panelerase (p);
+    }
+    return p;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: delete panel, the uncovered cells are drawn from the panels below
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delpanel (MCURSES_PANEL * p)
+{
+    mcurses_panel_unlink (p);
+    mcurses_panel_tab[p->id - 1] = (MCURSES_PANEL *) 0;
+    mcurses_panel_area (p, 0);
+    free (p->cells);
+    free (p);
+
+    if (mcurses_panel_n == 0)
+    {
+        free (mcurses_panel_owner);
+        mcurses_panel_owner = (uint8_t *) 0;
+#if MCURSES_VIRTUAL_SCREEN
+        free (mcurses_panel_under);
+        mcurses_panel_under = (chtype *) 0;
+#endif
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: show panel on top of all other panels
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+showpanel (MCURSES_PANEL * p)
+{
+    p->hidden = FALSE;
+    toppanel (p);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: hide panel, the uncovered cells are drawn from the panels below
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+hidepanel (MCURSES_PANEL * p)
+{
+    p->hidden = TRUE;
+    mcurses_panel_area (p, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: put panel on top of all other panels, only its cells covered until now are drawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+toppanel (MCURSES_PANEL * p)
+{
+    mcurses_panel_unlink (p);
+    mcurses_panel_stack[mcurses_panel_n++] = p;
+    mcurses_panel_area (p, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: put panel below all other panels, only its cells now covered by other panels are drawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+bottompanel (MCURSES_PANEL * p)
+{
+    mcurses_panel_unlink (p);
+    memmove (mcurses_panel_stack + 1, mcurses_panel_stack, mcurses_panel_n * sizeof (MCURSES_PANEL *));
+    mcurses_panel_stack[0] = p;
+    mcurses_panel_n++;
+    mcurses_panel_area (p, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: move panel to line y, column x of screen. The uncovered cells are drawn from the panels below, the visible
+ * cells of the panel at its new position.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+movepanel (MCURSES_PANEL * p, uint8_t y, uint8_t x)
+{
+    uint8_t     oldy = p->begy;
+    uint8_t     oldx = p->begx;
+
+    if (y == oldy && x == oldx)
+    {
+        return;
+    }
+
+    p->begy = y;
+    p->begx = x;
+
+    mcurses_panel_update (oldy, oldx, p->maxy, p->maxx, 0);
+    mcurses_panel_area (p, p->id);                                              // contents have moved: draw all own cells
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: move cursor in panel
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+panelmove (MCURSES_PANEL * p, uint8_t y, uint8_t x)
+{
+    if (y < p->maxy && x < p->maxx)
+    {
+        p->cury = y;
+        p->curx = x;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: set attribute of characters added from now on
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+panelattrset (MCURSES_PANEL * p, uint16_t attr)
+{
+    p->attr = attr;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add character to panel, draw it if it is visible
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_panel_addch (MCURSES_PANEL * p, uint8_t ch)
+{
+    MCURSES_PANEL_CELL *    cp;
+    uint8_t                 y;
+    uint8_t                 x;
+
+    if (ch == '\n')
+    {
+        p->curx = 0;
+
+        if (p->cury < p->maxy - 1)
+        {
+            p->cury++;
+        }
+        return;
+    }
+
+    if (ch < ' ' || p->cury >= p->maxy)
+    {
+        return;
+    }
+
+    cp          = p->cells + p->cury * p->maxx + p->curx;
+    cp->ch      = ch;
+    cp->attr    = p->attr;
+    y           = p->begy + p->cury;
+    x           = p->begx + p->curx;
+
+    if (y < LINES && x < COLS && OWNER (y, x) == p->id)                         // not covered by a higher panel
+    {
+        mcurses_panel_put (y, x, ch, p->attr);
+    }
+
+    if (++p->curx == p->maxx)                                                   // wrap, stay in last cell of panel
+    {
+        if (p->cury < p->maxy - 1)
+        {
+            p->curx = 0;
+            p->cury++;
+        }
+        else
+        {
+            p->curx--;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: add character to panel, it is drawn only if it is not covered by a higher panel
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+paneladdch (MCURSES_PANEL * p, uint8_t ch)
+{
+    mcurses_panel_begin ();
+    mcurses_panel_addch (p, ch);
+    mcurses_panel_end ();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: add string to panel, only characters not covered by a higher panel are drawn
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+paneladdstr (MCURSES_PANEL * p, const char * str)
+{
+    mcurses_panel_begin ();
+
+    while (*str)
+    {
+        mcurses_panel_addch (p, *str++);
+    }
+
+    mcurses_panel_end ();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: fill panel with spaces in its attribute, cursor goes home
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+panelerase (MCURSES_PANEL * p)
+{
+    uint16_t    n = (uint16_t) p->maxy * p->maxx;
+    uint16_t    i;
+
+    for (i = 0; i < n; i++)
+    {
+        p->cells[i].ch      = ' ';
+        p->cells[i].attr    = p->attr;
+    }
+
+    p->cury = 0;
+    p->curx = 0;
+    mcurses_panel_area (p, p->id);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PANEL: screen has been cleared, draw visible cells of all panels
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+redrawpanels (void)
+{
+    if (mcurses_panel_owner)
+    {
+        memset (mcurses_panel_owner, 0, (uint16_t) LINES * COLS);
+        mcurses_panel_update (0, 0, LINES, COLS, 0);
+    }
+}
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-panel.h - include file for mcurses panels
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_PANEL_H
+#define MCURSES_PANEL_H
+
+#include "mcurses.h"
+
+#define PANEL_MAX               32                                                  // max. number of panels
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * cell of a panel
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t             ch;                                                         // character
+    uint16_t            attr;                                                       // attribute
+} MCURSES_PANEL_CELL;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * panel: rectangle with its own contents in a stack of panels, see newpanel()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t             id;                                                         // 1...PANEL_MAX
+    uint8_t             hidden;                                                     // TRUE: panel is hidden
+    uint8_t             begy;                                                       // line on screen
+    uint8_t             begx;                                                       // column on screen
+    uint8_t             maxy;                                                       // number of lines
+    uint8_t             maxx;                                                       // number of columns
+    uint8_t             cury;                                                       // cursor line in panel
+    uint8_t             curx;                                                       // cursor column in panel
+    uint16_t            attr;                                                       // attribute of new characters
+    MCURSES_PANEL_CELL * cells;                                                     // contents: maxy * maxx cells
+} MCURSES_PANEL;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * panel functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_PANEL *          newpanel (uint8_t, uint8_t, uint8_t, uint8_t);     // create panel on top: lines, columns, begin line, begin column
+extern void                     delpanel (MCURSES_PANEL *);                         // delete panel, uncover panels below
+extern void                     showpanel (MCURSES_PANEL *);                        // show panel on top of stack
+extern void                     hidepanel (MCURSES_PANEL *);                        // hide panel
+extern void                     toppanel (MCURSES_PANEL *);                         // put panel on top of stack
+extern void                     bottompanel (MCURSES_PANEL *);                      // put panel at bottom of stack
+extern void                     movepanel (MCURSES_PANEL *, uint8_t, uint8_t);      // move panel to line, column on screen
+extern void                     panelmove (MCURSES_PANEL *, uint8_t, uint8_t);      // move cursor in panel
+extern void                     panelattrset (MCURSES_PANEL *, uint16_t);           // set attribute of new characters
+extern void                     paneladdch (MCURSES_PANEL *, uint8_t);              // add a character to panel
+extern void                     paneladdstr (MCURSES_PANEL *, const char *);        // add a string to panel
+extern void                     panelerase (MCURSES_PANEL *);                       // clear panel with its attribute
+extern void                     redrawpanels (void);                                // screen has been cleared, draw all panels
+
+#endif // MCURSES_PANEL_H
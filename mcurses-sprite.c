@@ -0,0 +1,348 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-sprite.c - sprites for mcurses lib
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mcurses-sprite.h"
+
+static uint16_t                 mcurses_sprite_attr;                                // attribute set by last mcurses_sprite_put()
+static uint8_t                  mcurses_sprite_attr_valid;                          // TRUE: mcurses_sprite_attr is valid
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: output cell at screen position y, x
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_sprite_put (uint8_t y, uint8_t x, MCURSES_SPRITE_CELL * cp)
+{
+    uint8_t     cy;
+    uint8_t     cx;
+
+    getyx (cy, cx);
+
+    if (cy != y || cx != x)
+    {
+        move (y, x);
+    }
+
+    if (! mcurses_sprite_attr_valid || cp->attr != mcurses_sprite_attr)
+    {
+        attrset (cp->attr);
+        mcurses_sprite_attr         = cp->attr;
+        mcurses_sprite_attr_valid   = TRUE;
+    }
+    addch (cp->ch);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: get cell at screen position y, x when sprite is placed at begy, begx. Returns FALSE if the cell is outside
+ * of the sprite or transparent.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_sprite_cell (MCURSES_SPRITE * s, uint8_t begy, uint8_t begx, uint8_t y, uint8_t x, MCURSES_SPRITE_CELL * cp)
+{
+    uint16_t    idx;
+
+    if (y < begy || y >= begy + s->maxy || x < begx || x >= begx + s->maxx)
+    {
+        return FALSE;
+    }
+
+    idx = (uint16_t) (y - begy) * s->maxx + (x - begx);
+
+    if (! (s->mask[idx >> 3] & (1 << (idx & 0x07))))
+    {
+        return FALSE;
+    }
+
+    *cp = s->cells[idx];
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: get background at screen position y, x
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_sprite_background (MCURSES_SPRITE * s, uint8_t y, uint8_t x, MCURSES_SPRITE_CELL * cp)
+{
+    if (s->func)
+    {
+        (*s->func) (y, x, &cp->ch, &cp->attr, s->data);
+    }
+    else
+    {
+        cp->ch      = ' ';
+        cp->attr    = A_NORMAL;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: sprite was on screen at oy, ox if oshown, now it is at ny, nx if nshown: draw differences
+ *
+ * Pass 0 walks the old rectangle, pass 1 the part of the new rectangle outside of the old one. For each cell the
+ * old and the new contents, sprite or background, are compared. Only cells which differ are drawn, so a sprite moved
+ * by one column costs its left and right edge instead of all its cells.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_sprite_update (MCURSES_SPRITE * s, uint8_t oshown, uint8_t oy, uint8_t ox, uint8_t nshown, uint8_t ny, uint8_t nx)
+{
+    MCURSES_SPRITE_CELL old;
+    MCURSES_SPRITE_CELL new;
+    uint8_t             o;
+    uint8_t             n;
+    uint8_t             pass;
+    uint8_t             begy;
+    uint8_t             begx;
+    uint16_t            y;
+    uint16_t            x;
+
+    mcurses_sprite_attr_valid = FALSE;                                          // someone else may have set attribute
+
+    for (pass = 0; pass < 2; pass++)
+    {
+        if (pass == 0 ? ! oshown : ! nshown)
+        {
+            continue;
+        }
+
+        begy = (pass == 0) ? oy : ny;
+        begx = (pass == 0) ? ox : nx;
+
+        for (y = begy; y < begy + s->maxy && y < LINES; y++)
+        {
+            for (x = begx; x < begx + s->maxx && x < COLS; x++)
+            {
+                if (pass == 1 && oshown && y >= oy && y < oy + s->maxy && x >= ox && x < ox + s->maxx)
+                {
+                    continue;                                                   // already handled in pass 0
+                }
+
+                o = oshown && mcurses_sprite_cell (s, oy, ox, y, x, &old);
+                n = nshown && mcurses_sprite_cell (s, ny, nx, y, x, &new);
+
+                if (! o && ! n)
+                {
+                    continue;                                                   // background before and after
+                }
+
+                if (! o)
+                {
+                    mcurses_sprite_background (s, y, x, &old);
+                }
+                else if (! n)
+                {
+                    mcurses_sprite_background (s, y, x, &new);
+                }
+
+                if (old.ch != new.ch || old.attr != new.attr)
+                {
+                    mcurses_sprite_put (y, x, &new);
+                }
+            }
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: change cell at line y, column x of sprite, draw it if sprite is on screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_sprite_change (MCURSES_SPRITE * s, uint8_t y, uint8_t x, uint8_t ch, uint16_t attr, uint8_t opaque)
+{
+    MCURSES_SPRITE_CELL old;
+    MCURSES_SPRITE_CELL new;
+    uint16_t            idx;
+    uint8_t             sy;
+    uint8_t             sx;
+
+    if (y >= s->maxy || x >= s->maxx)
+    {
+        return;
+    }
+
+    sy = s->begy + y;
+    sx = s->begx + x;
+
+    if (s->shown && ! mcurses_sprite_cell (s, s->begy, s->begx, sy, sx, &old))
+    {
+        mcurses_sprite_background (s, sy, sx, &old);
+    }
+
+    idx = (uint16_t) y * s->maxx + x;
+
+    if (opaque)
+    {
+        s->cells[idx].ch    = ch;
+        s->cells[idx].attr  = attr;
+        s->mask[idx >> 3]  |= (1 << (idx & 0x07));
+    }
+    else
+    {
+        s->mask[idx >> 3]  &= ~(1 << (idx & 0x07));
+    }
+
+    if (s->shown && (uint16_t) s->begy + y < LINES && (uint16_t) s->begx + x < COLS)
+    {
+        if (! mcurses_sprite_cell (s, s->begy, s->begx, sy, sx, &new))
+        {
+            mcurses_sprite_background (s, sy, sx, &new);
+        }
+
+        if (old.ch != new.ch || old.attr != new.attr)
+        {
+            mcurses_sprite_attr_valid = FALSE;
+            mcurses_sprite_put (sy, sx, &new);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: create sprite of nlines x ncols cells, all transparent. The sprite is not shown and placed at line 0,
+ * column 0. Returns NULL if there is no memory.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+MCURSES_SPRITE *
+newsprite (uint8_t nlines, uint8_t ncols)
+{
+    MCURSES_SPRITE *    s;
+    uint16_t            n = (uint16_t) nlines * ncols;
+
+    s = calloc (1, sizeof (MCURSES_SPRITE));
+
+    if (s)
+    {
+        s->cells    = calloc (n, sizeof (MCURSES_SPRITE_CELL));
+        s->mask     = calloc ((n + 7) / 8, 1);
+
+        if (! s->cells || ! s->mask)
+        {
+            free (s->cells);
+            free (s->mask);
+            free (s);
+            return (MCURSES_SPRITE *) 0;
+        }
+
+        s->maxy = nlines;
+        s->maxx = ncols;
+    }
+    return s;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: delete sprite, the screen remains unchanged - call spritehide() before to restore the background
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delsprite (MCURSES_SPRITE * s)
+{
+    free (s->cells);
+    free (s->mask);
+    free (s);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: set background callback, which returns what is below the sprite. If func is NULL, the background is blank.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spritebackground (MCURSES_SPRITE * s, MCURSES_SPRITE_FUNC func, void * data)
+{
+    s->func = func;
+    s->data = data;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: set cell at line y, column x of sprite to ch with attribute attr and make it opaque
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spriteset (MCURSES_SPRITE * s, uint8_t y, uint8_t x, uint8_t ch, uint16_t attr)
+{
+    mcurses_sprite_change (s, y, x, ch, attr, TRUE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: set cells from line y, column x of sprite to characters of str with attribute attr and make them opaque
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spritesetstr (MCURSES_SPRITE * s, uint8_t y, uint8_t x, const char * str, uint16_t attr)
+{
+    while (*str && x < s->maxx)
+    {
+        mcurses_sprite_change (s, y, x, *str, attr, TRUE);
+        str++;
+        x++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: make cell at line y, column x of sprite transparent
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spriteclear (MCURSES_SPRITE * s, uint8_t y, uint8_t x)
+{
+    mcurses_sprite_change (s, y, x, ' ', A_NORMAL, FALSE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: draw sprite on screen. Opaque cells which equal the background are not drawn.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spriteshow (MCURSES_SPRITE * s)
+{
+    if (! s->shown)
+    {
+        mcurses_sprite_update (s, FALSE, 0, 0, TRUE, s->begy, s->begx);
+        s->shown = TRUE;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: remove sprite from screen, the background callback restores the cells below
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spritehide (MCURSES_SPRITE * s)
+{
+    if (s->shown)
+    {
+        mcurses_sprite_update (s, TRUE, s->begy, s->begx, FALSE, 0, 0);
+        s->shown = FALSE;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SPRITE: move sprite to line y, column x on screen
+ *
+ * If the sprite is shown, only the cells which differ between the old and the new position are drawn. The attribute
+ * of the cell drawn last remains set.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+spritemove (MCURSES_SPRITE * s, uint8_t y, uint8_t x)
+{
+    if (s->shown)
+    {
+        mcurses_sprite_update (s, TRUE, s->begy, s->begx, TRUE, y, x);
+    }
+
+    s->begy = y;
+    s->begx = x;
+}
@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-sprite.h - include file for mcurses sprites
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#ifndef MCURSES_SPRITE_H
+#define MCURSES_SPRITE_H
+
+#include "mcurses.h"
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * background callback: store character and attribute of screen position y, x below sprites in ch and attr
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef void (* MCURSES_SPRITE_FUNC) (uint8_t y, uint8_t x, uint8_t * ch, uint16_t * attr, void * data);
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * cell of a sprite
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t             ch;                                                         // character
+    uint16_t            attr;                                                       // attribute
+} MCURSES_SPRITE_CELL;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * sprite: block of cells with transparency mask, placed on screen, see newsprite()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t             maxy;                                                       // number of lines
+    uint8_t             maxx;                                                       // number of columns
+    uint8_t             begy;                                                       // line on screen
+    uint8_t             begx;                                                       // column on screen
+    uint8_t             shown;                                                      // TRUE: sprite is on screen
+    MCURSES_SPRITE_FUNC func;                                                       // background callback or NULL: blanks
+    void *              data;                                                       // argument of background callback
+    MCURSES_SPRITE_CELL * cells;                                                    // contents: maxy * maxx cells
+    uint8_t *           mask;                                                       // bit per cell, set: cell is opaque
+} MCURSES_SPRITE;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * sprite functions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+extern MCURSES_SPRITE *         newsprite (uint8_t, uint8_t);                       // create transparent sprite: lines, columns
+extern void                     delsprite (MCURSES_SPRITE *);                       // delete sprite, screen remains unchanged
+extern void                     spritebackground (MCURSES_SPRITE *, MCURSES_SPRITE_FUNC, void *);  // set background callback
+extern void                     spriteset (MCURSES_SPRITE *, uint8_t, uint8_t, uint8_t, uint16_t);  // set opaque cell: line, column, ch, attr
+extern void                     spritesetstr (MCURSES_SPRITE *, uint8_t, uint8_t, const char *, uint16_t); // set opaque cells from string
+extern void                     spriteclear (MCURSES_SPRITE *, uint8_t, uint8_t);   // make cell transparent
+extern void                     spriteshow (MCURSES_SPRITE *);                      // draw sprite on screen
+extern void                     spritehide (MCURSES_SPRITE *);                      // remove sprite from screen, restore background
+extern void                     spritemove (MCURSES_SPRITE *, uint8_t, uint8_t);    // move sprite to line, column on screen
+
+#endif // MCURSES_SPRITE_H
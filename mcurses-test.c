@@ -0,0 +1,1893 @@
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * @file mcurses-test.c - replay test for mcurses lib (UNIX)
+ *
+ * Copyright (c) 2011-2014 Frank Meyer - frank(at)fli4l.de
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * The output of mcurses goes to a temporary file. The file is played back on a small VT100 model and the model screen
+ * is compared with the expected contents. Call: make -f Makefile.unix test
+ *
+ * The random tests keep a shadow screen of what the calls should have put on the screen and compare it with the model
+ * for 30 seeds and all combinations of terminal capabilities. They run with virtual screen (mcurses-test) and in
+ * immediate mode (mcurses-test-immediate).
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "mcurses.h"
+#include "mcurses-log.h"
+#include "mcurses-pager.h"
+#include "mcurses-list.h"
+#include "mcurses-grid.h"
+#include "mcurses-panel.h"
+
+#define AE                      "\xC3\xA4"                                      // UTF-8 of test characters
+#define OE                      "\xC3\xB6"
+#define EURO                    "\xE2\x82\xAC"
+#define CJK1                    "\xE6\x97\xA5"                                  // wide characters
+#define CJK2                    "\xE6\x9C\xAC"
+#define CJK3                    "\xE8\xAA\x9E"
+#define VT_WIDE_RIGHT           0x110000                                        // model cell holds right half of wide character
+
+#define CAP_RECT                0x01                                            // random test: rectoutput (TRUE)
+#define CAP_REP                 0x02                                            // random test: repoutput (TRUE)
+#define CAP_MARGINS             0x04                                            // random test: marginoutput (TRUE)
+#define CAPS                    0x08                                            // number of capability combinations
+
+#define SEEDS                   30                                              // random test: runs per combination
+#define OPS                     200                                             // random test: calls per run
+#define ASYNC_OPS               3000                                            // async test: calls
+#define SLOW_BLOCK              512                                             // async test: terminal reads 512 bytes,
+#define SLOW_USECS              2000                                            // then waits 2 msec: 256 KB/s
+
+#define COLORS                  4                                               // random test: color pairs 1..4
+#define ATTR_BG(a)              (((a) & A_COLORPAIR) ? ((a) & (0xFF00 | A_COLORPAIR)) : ((a) & B_COLOR))
+#define A_FLAGS                 (A_UNDERLINE | A_REVERSE | A_BLINK | A_BOLD | A_DIM)
+
+typedef struct
+{
+    uint32_t    ch;                                                             // code point, ACS: 0x80-0x9F as in chtype
+    uint8_t     flags;                                                          // A_UNDERLINE ... A_DIM
+    int32_t     fg;                                                             // COLOR_DEFAULT, 0...255 or COLOR_RGB()
+    int32_t     bg;
+} VT_CELL;
+
+static VT_CELL          vt_screen[LINES][COLS];                                 // model screen
+static int              vt_y;                                                   // cursor line
+static int              vt_x;                                                   // cursor column
+static int              vt_wrap;                                                // cursor in last column, next character wraps
+static int              vt_top;                                                 // scrolling region top
+static int              vt_bottom;                                              // scrolling region bottom
+static int              vt_lrmm;                                                // DECLRMM: left/right margins allowed
+static int              vt_left;                                                // left margin, DECSLRM
+static int              vt_right;                                               // right margin
+static int              vt_saved_y;                                             // DECSC
+static int              vt_saved_x;
+static int              vt_insert;                                              // IRM: insert mode
+static int              vt_g1;                                                  // SO: G1 (DEC special graphics) active
+static uint32_t         vt_last;                                                // last graphic character, for REP
+static VT_CELL          vt_pen;                                                 // SGR: rendition of next character
+static int              vt_onlcr;                                               // LF also returns to column 0 (tty ONLCR)
+
+static chtype           sh_screen[LINES][COLS];                                 // shadow screen: what the calls should show
+static uint16_t         sh_attr;                                                // attribute set by attrset()
+static int32_t          sh_pairs[COLORS + 1][2];                                // colors set by init_pair()
+static uint32_t         rnd_state;                                              // random generator
+static int              slow_fd;                                                // async test: read end of pipe
+static FILE *           slow_fp;                                                // async test: output file
+
+static const char       test_chars[] = "abcdefghijklmnopqrstuvwxyz    \x91\x98";  // ACS_HLINE, ACS_VLINE
+static const uint16_t   test_attrs[] =
+{
+    A_NORMAL, A_BOLD, A_REVERSE, A_DIM | A_BLINK, F_RED, F_WHITE | B_BLUE, A_UNDERLINE | F_GREEN | B_BLACK, B_CYAN | A_BOLD,
+    COLOR_PAIR(1), COLOR_PAIR(2) | A_BOLD, COLOR_PAIR(3) | A_REVERSE, COLOR_PAIR(4) | A_UNDERLINE | A_DIM
+};
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: blank n cells of line y from column x on
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_blank (int y, int x, int n)
+{
+    while (n-- > 0)                                                             // blank with background of pen (BCE)
+    {
+        vt_screen[y][x].ch      = ' ';
+        vt_screen[y][x].flags   = 0;
+        vt_screen[y][x].fg      = COLOR_DEFAULT;
+        vt_screen[y][x].bg      = vt_pen.bg;
+        x++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: width of a code point, enough for the test characters: CJK, Hangul and fullwidth forms are wide
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+vt_width (uint32_t ch)
+{
+    return ((ch >= 0x2E80 && ch <= 0xA4CF) || (ch >= 0xAC00 && ch <= 0xD7A3) || (ch >= 0xFF01 && ch <= 0xFF60)) ? 2 : 1;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: cells x1..x2 of line y get overwritten: like xterm, erase the halves of wide characters cut at the edges
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_unsplit (int y, int x1, int x2)
+{
+    if (x1 > 0 && vt_screen[y][x1].ch == VT_WIDE_RIGHT && vt_width (vt_screen[y][x1 - 1].ch) == 2)
+    {
+        vt_blank (y, x1 - 1, 1);
+    }
+
+    if (x2 < COLS - 1 && vt_screen[y][x2 + 1].ch == VT_WIDE_RIGHT && vt_width (vt_screen[y][x2].ch) == 2)
+    {
+        vt_blank (y, x2 + 1, 1);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: scroll lines top..bottom between left and right margin n lines up (n > 0) or down (n < 0)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_scroll (int top, int bottom, int n)
+{
+    int     ncols = vt_right - vt_left + 1;
+    int     y;
+
+    while (n > 0)
+    {
+        for (y = top; y < bottom; y++)
+        {
+            memmove (vt_screen[y] + vt_left, vt_screen[y + 1] + vt_left, ncols * sizeof (VT_CELL));
+        }
+        vt_blank (bottom, vt_left, ncols);
+        n--;
+    }
+
+    while (n < 0)
+    {
+        for (y = bottom; y > top; y--)
+        {
+            memmove (vt_screen[y] + vt_left, vt_screen[y - 1] + vt_left, ncols * sizeof (VT_CELL));
+        }
+        vt_blank (top, vt_left, ncols);
+        n++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: clamp cursor to screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_clamp (void)
+{
+    if (vt_y < 0)           vt_y = 0;
+    if (vt_y > LINES - 1)   vt_y = LINES - 1;
+    if (vt_x < 0)           vt_x = 0;
+    if (vt_x > COLS - 1)    vt_x = COLS - 1;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: line feed, scroll at bottom margin
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_linefeed (void)
+{
+    if (vt_y == vt_bottom)
+    {
+        vt_scroll (vt_top, vt_bottom, 1);
+    }
+    else if (vt_y < LINES - 1)
+    {
+        vt_y++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: put graphic character at cursor, autowrap as xterm: the cursor stays in the last column until the next character
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_print (uint32_t ch)
+{
+    int w = vt_width (ch);
+
+    if (vt_g1 && ch >= 0x60 && ch <= 0x7E)                                      // DEC special graphics, stored as ACS
+    {
+        ch += 0x20;
+    }
+
+    if (vt_wrap)
+    {
+        vt_x = 0;
+        vt_linefeed ();
+        vt_wrap = 0;
+    }
+
+    if (w == 2 && vt_x == COLS - 1)                                             // wide character in last column wraps
+    {
+        vt_x = 0;
+        vt_linefeed ();
+    }
+
+    if (vt_insert)
+    {
+        memmove (vt_screen[vt_y] + vt_x + w, vt_screen[vt_y] + vt_x, (COLS - vt_x - w) * sizeof (VT_CELL));
+    }
+
+    vt_unsplit (vt_y, vt_x, vt_x + w - 1);
+    vt_screen[vt_y][vt_x] = vt_pen;
+    vt_screen[vt_y][vt_x].ch = ch;
+    vt_last = ch;
+
+    if (w == 2)
+    {
+        vt_screen[vt_y][vt_x + 1] = vt_pen;
+        vt_screen[vt_y][vt_x + 1].ch = VT_WIDE_RIGHT;
+    }
+
+    if (vt_x + w < COLS)
+    {
+        vt_x += w;
+    }
+    else
+    {
+        vt_wrap = 1;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: get parameter i of a rectangle sequence, 1-based on the wire, 0-based here
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+vt_param (int * par, int npar, int i, int deflt)
+{
+    return (i < npar && par[i] > 0) ? par[i] - 1 : deflt;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: execute rectangle sequence: DECFRA (fill), DECERA (erase), DECCRA (copy)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_rect (int * par, int npar, int final)
+{
+    static VT_CELL  buf[LINES][COLS];
+    int             i = (final == 'x') ? 1 : 0;                                 // DECFRA: character first
+    int             top     = vt_param (par, npar, i,     0);
+    int             left    = vt_param (par, npar, i + 1, 0);
+    int             bottom  = vt_param (par, npar, i + 2, LINES - 1);
+    int             right   = vt_param (par, npar, i + 3, COLS - 1);
+    int             dsty    = vt_param (par, npar, 5, 0);
+    int             dstx    = vt_param (par, npar, 6, 0);
+    uint32_t        ch      = (npar > 0) ? par[0] : ' ';
+    int             y;
+    int             x;
+
+    if (bottom > LINES - 1) bottom = LINES - 1;
+    if (right > COLS - 1)   right = COLS - 1;
+
+    if (final == 'x' && vt_g1 && ch >= 0x60 && ch <= 0x7E)                      // fill character from active set
+    {
+        ch += 0x20;
+    }
+
+    for (y = top; y <= bottom; y++)
+    {
+        for (x = left; x <= right; x++)
+        {
+            if (final == 'x')
+            {
+                vt_screen[y][x] = vt_pen;
+                vt_screen[y][x].ch = ch;
+            }
+            else if (final == 'z')
+            {
+                vt_blank (y, x, 1);
+            }
+            else
+            {
+                buf[y][x] = vt_screen[y][x];
+            }
+        }
+    }
+
+    if (final == 'v')
+    {
+        for (y = top; y <= bottom && dsty + y - top < LINES; y++)               // destination ends at the edges
+        {
+            for (x = left; x <= right && dstx + x - left < COLS; x++)
+            {
+                vt_screen[dsty + y - top][dstx + x - left] = buf[y][x];
+            }
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: get color of SGR 38 or 48 from par[i], return index of last parameter used
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+vt_color (int * par, int npar, int i, int32_t * color)
+{
+    if (i + 2 < npar && par[i + 1] == 5)                                        // 38;5;n
+    {
+        *color = par[i + 2];
+        return i + 2;
+    }
+
+    if (i + 4 < npar && par[i + 1] == 2)                                        // 38;2;r;g;b
+    {
+        *color = COLOR_RGB (par[i + 2], par[i + 3], par[i + 4]);
+        return i + 4;
+    }
+    return npar;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: execute SGR sequence
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_sgr (int * par, int npar)
+{
+    int     i;
+    int     p;
+
+    if (npar == 0)
+    {
+        npar = 1;                                                               // CSI m: par[0] = 0
+    }
+
+    for (i = 0; i < npar; i++)
+    {
+        p = par[i];
+
+        if (p == 0)
+        {
+            vt_pen.flags    = 0;
+            vt_pen.fg       = COLOR_DEFAULT;
+            vt_pen.bg       = COLOR_DEFAULT;
+        }
+        else if (p == 1)                vt_pen.flags |= A_BOLD;
+        else if (p == 2)                vt_pen.flags |= A_DIM;
+        else if (p == 4)                vt_pen.flags |= A_UNDERLINE;
+        else if (p == 5)                vt_pen.flags |= A_BLINK;
+        else if (p == 7)                vt_pen.flags |= A_REVERSE;
+        else if (p == 22)               vt_pen.flags &= ~(A_BOLD | A_DIM);
+        else if (p == 24)               vt_pen.flags &= ~A_UNDERLINE;
+        else if (p == 25)               vt_pen.flags &= ~A_BLINK;
+        else if (p == 27)               vt_pen.flags &= ~A_REVERSE;
+        else if (p >= 30 && p <= 37)    vt_pen.fg = p - 30;
+        else if (p == 38)               i = vt_color (par, npar, i, &vt_pen.fg);
+        else if (p == 39)               vt_pen.fg = COLOR_DEFAULT;
+        else if (p >= 40 && p <= 47)    vt_pen.bg = p - 40;
+        else if (p == 48)               i = vt_color (par, npar, i, &vt_pen.bg);
+        else if (p == 49)               vt_pen.bg = COLOR_DEFAULT;
+        else if (p >= 90 && p <= 97)    vt_pen.fg = p - 90 + 8;
+        else if (p >= 100 && p <= 107)  vt_pen.bg = p - 100 + 8;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: execute CSI sequence
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_csi (int prefix, int inter, int * par, int npar, int final)
+{
+    int     n = (npar > 0 && par[0] > 0) ? par[0] : 1;
+    int     x;
+
+    if (prefix)                                                                 // DEC private modes, queries
+    {
+        if (prefix == '?' && (final == 'h' || final == 'l') && npar > 0 && par[0] == 69)
+        {                                                                       // DECLRMM
+            vt_lrmm = (final == 'h');
+            vt_left = 0;
+            vt_right = COLS - 1;
+        }
+        return;
+    }
+
+    if (inter)
+    {
+        if (inter == '$' && (final == 'x' || final == 'z' || final == 'v'))
+        {
+            vt_rect (par, npar, final);
+        }
+        return;
+    }
+
+    if (final == 'm')                                                           // SGR
+    {
+        vt_sgr (par, npar);
+        return;
+    }
+
+    if (final == 'b')                                                           // REP
+    {
+        while (n-- > 0)
+        {
+            vt_print (vt_last);
+        }
+        return;
+    }
+
+    vt_wrap = 0;                                                                // other sequences end a pending wrap
+
+    switch (final)
+    {
+        case 'H': case 'f':                                                     // CUP
+            vt_y = n - 1;
+            vt_x = (npar > 1 && par[1] > 0) ? par[1] - 1 : 0;
+            break;
+        case 'A':   vt_y -= n;                                      break;      // CUU
+        case 'B':   vt_y += n;                                      break;      // CUD
+        case 'C':   vt_x += n;                                      break;      // CUF
+        case 'D':   vt_x -= n;                                      break;      // CUB
+        case 'G':   vt_x = n - 1;                                   break;      // CHA
+        case 'd':   vt_y = n - 1;                                   break;      // VPA
+        case 'S':   vt_scroll (vt_top, vt_bottom, n);               break;      // SU
+        case 'T':   vt_scroll (vt_top, vt_bottom, -n);              break;      // SD
+        case 'L':   if (vt_y >= vt_top && vt_y <= vt_bottom) vt_scroll (vt_y, vt_bottom, -n);  break;  // IL
+        case 'M':   if (vt_y >= vt_top && vt_y <= vt_bottom) vt_scroll (vt_y, vt_bottom, n);   break;  // DL
+        case 'h':   if (npar > 0 && par[0] == 4) vt_insert = 1;     break;      // SM: IRM
+        case 'l':   if (npar > 0 && par[0] == 4) vt_insert = 0;     break;      // RM: IRM
+        case 'K':                                                               // EL
+            x = npar > 0 ? par[0] : 0;
+            if (x == 0)         vt_blank (vt_y, vt_x, COLS - vt_x);
+            else if (x == 1)    vt_blank (vt_y, 0, vt_x + 1);
+            else                vt_blank (vt_y, 0, COLS);
+            break;
+        case 'J':                                                               // ED
+            if (npar > 0 && par[0] == 2)
+            {
+                for (x = 0; x < LINES; x++)
+                {
+                    vt_blank (x, 0, COLS);
+                }
+            }
+            else
+            {
+                vt_blank (vt_y, vt_x, COLS - vt_x);
+
+                for (x = vt_y + 1; x < LINES; x++)
+                {
+                    vt_blank (x, 0, COLS);
+                }
+            }
+            break;
+        case 'P':                                                               // DCH
+            x = (n < COLS - vt_x) ? n : COLS - vt_x;
+            memmove (vt_screen[vt_y] + vt_x, vt_screen[vt_y] + vt_x + x, (COLS - vt_x - x) * sizeof (VT_CELL));
+            vt_blank (vt_y, COLS - x, x);
+            break;
+        case '@':                                                               // ICH
+            x = (n < COLS - vt_x) ? n : COLS - vt_x;
+            memmove (vt_screen[vt_y] + vt_x + x, vt_screen[vt_y] + vt_x, (COLS - vt_x - x) * sizeof (VT_CELL));
+            vt_blank (vt_y, vt_x, x);
+            break;
+        case 'X':                                                               // ECH
+            x = (n < COLS - vt_x) ? n : COLS - vt_x;
+            vt_blank (vt_y, vt_x, x);
+            break;
+        case 'r':                                                               // DECSTBM, cursor goes home
+            vt_top     = (npar > 0 && par[0] > 0) ? par[0] - 1 : 0;
+            vt_bottom  = (npar > 1 && par[1] > 0) ? par[1] - 1 : LINES - 1;
+            vt_y = 0;
+            vt_x = 0;
+            break;
+        case 's':
+            if (vt_lrmm)                                                        // DECSLRM, cursor goes home
+            {
+                vt_left    = (npar > 0 && par[0] > 0) ? par[0] - 1 : 0;
+                vt_right   = (npar > 1 && par[1] > 0) ? par[1] - 1 : COLS - 1;
+                vt_y = 0;
+                vt_x = 0;
+            }
+            else                                                                // SCOSC
+            {
+                vt_saved_y = vt_y;
+                vt_saved_x = vt_x;
+            }
+            break;
+    }
+    vt_clamp ();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: decode UTF-8 sequence starting with byte ch, return code point
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+vt_utf8 (FILE * fp, int ch)
+{
+    uint32_t    cp;
+    int         len;
+
+    if (ch < 0xC0)
+    {
+        return ch;
+    }
+
+    len = (ch < 0xE0) ? 1 : (ch < 0xF0) ? 2 : 3;
+    cp  = ch & (0x3F >> len);
+
+    while (len--)
+    {
+        ch = getc (fp);
+
+        if ((ch & 0xC0) != 0x80)
+        {
+            ungetc (ch, fp);
+            break;
+        }
+        cp = (cp << 6) | (ch & 0x3F);
+    }
+    return cp;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * VT: play back output, UTF-8, no wide characters
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+vt_play (FILE * fp)
+{
+    int     par[16];
+    int     npar;
+    int     prefix;
+    int     inter;
+    int     ch;
+
+    vt_pen.ch = ' ';
+    vt_pen.flags = 0;
+    vt_pen.fg = COLOR_DEFAULT;
+    vt_pen.bg = COLOR_DEFAULT;
+
+    for (ch = 0; ch < LINES; ch++)
+    {
+        vt_blank (ch, 0, COLS);
+    }
+
+    vt_y = vt_x = 0;
+    vt_wrap = 0;
+    vt_top = 0;
+    vt_bottom = LINES - 1;
+    vt_lrmm = 0;
+    vt_left = 0;
+    vt_right = COLS - 1;
+    vt_insert = 0;
+    vt_g1 = 0;
+    vt_last = ' ';
+
+    while ((ch = getc (fp)) != EOF)
+    {
+        if (ch == '\033')
+        {
+            ch = getc (fp);
+
+            if (ch == '[')
+            {
+                npar = 0;
+                prefix = 0;
+                inter = 0;
+                par[0] = 0;
+
+                while ((ch = getc (fp)) != EOF && ch >= 0x20 && ch < 0x40)      // parameter and intermediate bytes
+                {
+                    if (ch >= '0' && ch <= '9')
+                    {
+                        if (npar == 0)
+                        {
+                            npar = 1;
+                        }
+                        par[npar - 1] = par[npar - 1] * 10 + ch - '0';
+                    }
+                    else if (ch == ';')
+                    {
+                        if (npar == 0)
+                        {
+                            npar = 1;
+                        }
+
+                        if (npar < 16)
+                        {
+                            par[npar++] = 0;
+                        }
+                    }
+                    else if (ch >= 0x3C)                                        // '<', '=', '>', '?'
+                    {
+                        prefix = ch;
+                    }
+                    else                                                        // '$', ' ', ...
+                    {
+                        inter = ch;
+                    }
+                }
+                vt_csi (prefix, inter, par, npar, ch);
+            }
+            else if (ch == '7')
+            {
+                vt_saved_y = vt_y;
+                vt_saved_x = vt_x;
+            }
+            else if (ch == '8')
+            {
+                vt_y = vt_saved_y;
+                vt_x = vt_saved_x;
+                vt_wrap = 0;
+            }
+            else if (ch == '(' || ch == ')')                                    // designate character set
+            {
+                (void) getc (fp);
+            }
+        }
+        else if (ch == '\r')
+        {
+            vt_x = 0;
+            vt_wrap = 0;
+        }
+        else if (ch == '\n')
+        {
+            if (vt_onlcr)
+            {
+                vt_x = 0;
+            }
+            vt_wrap = 0;
+            vt_linefeed ();
+        }
+        else if (ch == '\b')
+        {
+            if (vt_x > 0)
+            {
+                vt_x--;
+            }
+            vt_wrap = 0;
+        }
+        else if (ch == '\016')                                                  // SO: G1
+        {
+            vt_g1 = 1;
+        }
+        else if (ch == '\017')                                                  // SI: G0
+        {
+            vt_g1 = 0;
+        }
+        else if (ch >= 0x20 && ch != 0x7f)
+        {
+            vt_print (vt_utf8 (fp, ch));
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: store code point as UTF-8, ACS characters as their DEC character
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static char *
+test_utf8 (char * p, uint32_t cp)
+{
+    if (cp >= 0x80 && cp <= 0x9F)
+    {
+        *p++ = cp - 0x20;
+    }
+    else if (cp < 0x80)
+    {
+        *p++ = cp;
+    }
+    else if (cp < 0x800)
+    {
+        *p++ = 0xC0 | (cp >> 6);
+        *p++ = 0x80 | (cp & 0x3F);
+    }
+    else
+    {
+        *p++ = 0xE0 | (cp >> 12);
+        *p++ = 0x80 | ((cp >> 6) & 0x3F);
+        *p++ = 0x80 | (cp & 0x3F);
+    }
+    return p;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: character shown in column x of line y of model screen: 0 for right half of wide character, '?' for a half
+ * without the other half
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+test_shown (int y, int x)
+{
+    uint32_t    ch = vt_screen[y][x].ch;
+
+    if (ch == VT_WIDE_RIGHT)
+    {
+        return (x > 0 && vt_width (vt_screen[y][x - 1].ch) == 2) ? 0 : '?';
+    }
+
+    if (vt_width (ch) == 2 && (x == COLS - 1 || vt_screen[y][x + 1].ch != VT_WIDE_RIGHT))
+    {
+        return '?';
+    }
+    return ch;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: compare line y of model screen, starting at column x
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+expect (int y, int x, const char * str)
+{
+    const unsigned char *   s = (const unsigned char *) str;
+    uint32_t                want[COLS];
+    char                    line[4 * COLS + 1];
+    char *                  p = line;
+    uint32_t                cp;
+    int                     len;
+    int                     n = 0;
+    int                     i;
+    int                     k;
+
+    while (*s && n < COLS)                                                      // test strings are valid UTF-8
+    {
+        cp = *s++;
+
+        if (cp >= 0xC0)
+        {
+            len = (cp < 0xE0) ? 1 : (cp < 0xF0) ? 2 : 3;
+            cp &= 0x3F >> len;
+
+            while (len--)
+            {
+                cp = (cp << 6) | (*s++ & 0x3F);
+            }
+        }
+        want[n++] = cp;
+    }
+
+    for (i = 0, k = x; i < n && k < COLS; k++)                                 // right halves of wide characters are skipped
+    {
+        cp = test_shown (y, k);
+
+        if (cp != 0)
+        {
+            if (cp != want[i])
+            {
+                break;
+            }
+            i++;
+        }
+    }
+
+    if (i == n)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < COLS; i++)                                                  // show line as UTF-8
+    {
+        cp = test_shown (y, i);
+
+        if (cp != 0)
+        {
+            p = test_utf8 (p, cp);
+        }
+    }
+    *p = '\0';
+
+    fprintf (stderr, "line %2d: expected \"%s\" at column %d, got \"%s\"\n", y, str, x, line);
+    return 1;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: empty output file, start mcurses
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+test_begin (FILE * fp)
+{
+    rewind (fp);
+    (void) ftruncate (fileno (fp), 0);
+    initscr ();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: stop mcurses, play back output on model
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+test_end (FILE * fp, int onlcr)
+{
+    endwin ();
+    fflush (stdout);
+
+    rewind (fp);
+    vt_onlcr = onlcr;
+    vt_play (fp);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: terminal confirms rectangular editing and left/right margins, the replies are read by getch() from stdin
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_termcaps (FILE * fp)
+{
+    static const char   reply[] = "\033[?64;1;28c\033[?69;2$yx";                // DA1 with extension 28, DECRPM: mode 69 reset
+    FILE *              in;
+    uint8_t             ch;
+
+    in = tmpfile ();
+
+    if (! in || fwrite (reply, 1, sizeof (reply) - 1, in) != sizeof (reply) - 1 || fflush (in) != 0 ||
+        lseek (fileno (in), 0, SEEK_SET) != 0 || dup2 (fileno (in), fileno (stdin)) < 0)
+    {
+        perror ("tmpfile");
+        return 1;
+    }
+    fclose (in);
+
+    test_begin (fp);
+    rectoutput (TRUE);
+    marginoutput (TRUE);
+    ch = getch ();
+    marginoutput (FALSE);
+    test_end (fp, 0);
+
+    if (ch != 'x' || ! has_rectoutput () || ! has_marginoutput ())
+    {
+        fprintf (stderr, "test_termcaps failed: key 0x%02x, rect %d, margins %d\n", ch, has_rectoutput (), has_marginoutput ());
+        return 1;
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: LF scroll of a scrolling region, then an indented line at the bottom margin
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_lf_scroll (FILE * fp, int onlcr)
+{
+    int     errors = 0;
+
+    test_begin (fp);
+    setscrreg (2, LINES - 4);
+    mvaddstr (LINES - 4, 0, "first line");
+    refresh ();
+    scrl (1);                                                                   // DECSTBM now, it homes the cursor
+    refresh ();
+
+    mvaddstr (LINES - 4, 0, "second line");                                     // cursor stays behind the text
+    refresh ();
+
+    scrl (1);                                                                   // bottom margin: CR + LF is cheapest
+    mvaddstr (LINES - 4, 4, "indented");
+    refresh ();
+
+    test_end (fp, onlcr);
+
+    errors += expect (LINES - 6, 0, "first line");
+    errors += expect (LINES - 5, 0, "second line");
+    errors += expect (LINES - 4, 0, "    indented ");
+
+    if (errors)
+    {
+        fprintf (stderr, "test_lf_scroll (onlcr = %d) failed\n", onlcr);
+    }
+    return errors;
+}
+
+#if MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: deleted panel uncovers the screen contents below it, attribute of caller stays
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_panel (FILE * fp)
+{
+    MCURSES_PANEL * p;
+    int             errors = 0;
+
+    test_begin (fp);
+    mvaddstr (5, 0, "background below the panel");
+    attrset (F_RED);
+
+    p = newpanel (3, 10, 4, 4);
+
+    if (! p)
+    {
+        endwin ();
+        fprintf (stderr, "test_panel: newpanel() failed\n");
+        return 1;
+    }
+
+    panelattrset (p, F_WHITE | B_BLUE);
+    panelerase (p);
+    panelmove (p, 1, 1);
+    paneladdstr (p, "popup");
+    refresh ();
+
+    if (getattrs () != F_RED)
+    {
+        fprintf (stderr, "test_panel: attribute 0x%04x, expected 0x%04x\n", getattrs (), F_RED);
+        errors++;
+    }
+
+    delpanel (p);
+    attrset (A_NORMAL);
+    refresh ();
+
+    test_end (fp, 0);
+
+    errors += expect (5, 0, "background below the panel");
+
+    if (errors)
+    {
+        fprintf (stderr, "test_panel failed\n");
+    }
+    return errors;
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: row callback of list
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+test_list_row (uint32_t row, char * buf, uint16_t size, void * data)
+{
+    (void) data;
+    snprintf (buf, size, "%s", (row == 0) ? AE "bc" OE "de" EURO : "x");
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: cell callback of grid
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+test_grid_cell (uint32_t row, uint16_t col, char * buf, uint8_t size, uint16_t * attr, void * data)
+{
+    (void) row;
+    (void) attr;
+    (void) data;
+    snprintf (buf, size, "%s", (col == 0) ? OE OE OE OE OE : EURO "x");
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: log, pager, list and grid send UTF-8 text as it is and clip it by display width
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_utf8_widgets (FILE * fp)
+{
+    static const uint8_t    widths[2] = { 3, 4 };
+    char                    name[] = "/tmp/mcurses-test-XXXXXX";
+    const char *            text = "a\tb" EURO EURO EURO EURO "\n" "c\001" EURO "\n";
+    MCURSES_LOG *           log;
+    MCURSES_PAGER *         pg;
+    MCURSES_LIST *          ls;
+    MCURSES_GRID *          g;
+    WINDOW *                win[4];
+    int                     errors = 0;
+    int                     fd;
+
+    fd = mkstemp (name);
+
+    if (fd < 0 || write (fd, text, strlen (text)) != (ssize_t) strlen (text))
+    {
+        perror ("mkstemp");
+        return 1;
+    }
+    close (fd);
+
+    test_begin (fp);
+
+    win[0]  = newwin (2, 6, 0, 0);
+    win[1]  = newwin (2, 12, 3, 0);
+    win[2]  = newwin (2, 5, 6, 0);
+    win[3]  = newwin (1, 7, 9, 0);
+    log     = newlog (win[0]);
+    pg      = newpager (win[1], name);
+    ls      = newlist (win[2], 2, test_list_row, (void *) 0);
+    g       = newgrid (win[3], 1, 2, widths, test_grid_cell, (void *) 0);
+
+    if (! win[0] || ! win[1] || ! win[2] || ! win[3] || ! log || ! pg || ! ls || ! g)
+    {
+        endwin ();
+        unlink (name);
+        fprintf (stderr, "test_utf8_widgets: out of memory\n");
+        return 1;
+    }
+
+    logaddstr (log, AE OE AE OE AE OE AE OE);
+    logdraw (log);
+    pagerdraw (pg);
+    listdraw (ls);
+    griddraw (g);
+    refresh ();
+
+    test_end (fp, 0);
+    unlink (name);
+
+    errors += expect (1, 0, AE OE AE OE AE OE " ");                             // 8 characters cut at 6 columns
+    errors += expect (3, 0, "a       b" EURO EURO EURO " ");                    // tab, then 3 of 4 characters
+    errors += expect (4, 0, "c?" EURO " ");                                     // control character
+    errors += expect (6, 0, AE "bc" OE "d ");
+    errors += expect (7, 0, "x    ");
+    errors += expect (9, 0, OE OE OE EURO "x   ");
+
+    dellog (log);
+    delpager (pg);
+    dellist (ls);
+    delgrid (g);
+
+    for (fd = 0; fd < 4; fd++)
+    {
+        delwin (win[fd]);
+    }
+
+    if (errors)
+    {
+        fprintf (stderr, "test_utf8_widgets failed\n");
+    }
+    return errors;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: wide characters wrap at the last column; halves cut by overwriting, delch(), insch(), copyrect() or scrolling
+ * a window are blanked, with and without rectangular editing and left/right margins
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_wide (FILE * fp, int caps)
+{
+    int                 errors = 0;
+#if MCURSES_VIRTUAL_SCREEN
+    WINDOW *            win;
+#endif
+
+    test_begin (fp);
+    rectoutput ((caps & CAP_RECT) ? TRUE : FALSE);
+    marginoutput ((caps & CAP_MARGINS) ? TRUE : FALSE);
+
+    mvaddstr (0, COLS - 2, "a" CJK1 "b");                                       // CJK1 doesn't fit into last column
+#if MCURSES_VIRTUAL_SCREEN
+    mvaddstr (3, 0, CJK1 CJK2 CJK3);
+    mvaddstr (5, 0, "a" CJK1 "b");
+    mvaddstr (7, 0, "a" CJK1 "b");
+    mvaddstr (9, 0, CJK1 CJK2);
+    mvaddstr (12, 0, CJK1 CJK2 CJK3 "abc");
+    refresh ();
+
+    mvaddch (3, 1, 'x');                                                        // right half of CJK1
+    move (5, 1);                                                                // left half of CJK1
+    delch ();
+    move (7, 2);                                                                // between the halves of CJK1
+    insch ('x');
+    copyrect (9, 1, 1, 3, 10, 4);                                               // right half of CJK1, CJK2
+    win = newwin (2, 4, 12, 1);                                                 // cuts CJK1 and CJK3
+
+    if (win)
+    {
+        wscrl (win, 1);
+        delwin (win);
+    }
+#endif
+    refresh ();
+    test_end (fp, 0);
+
+    errors += expect (0, COLS - 2, "a ");
+    errors += expect (1, 0, CJK1 "b ");
+#if MCURSES_VIRTUAL_SCREEN
+    errors += expect (3, 0, " x" CJK2 CJK3 " ");
+    errors += expect (5, 0, "a b ");
+    errors += expect (7, 0, "a x b ");
+    errors += expect (10, 0, "     " CJK2 " ");
+    errors += expect (12, 0, "      abc ");
+#endif
+
+    if (errors)
+    {
+        fprintf (stderr, "test_wide: failed with caps %d\n", caps);
+    }
+    return errors;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: random number 0..n-1, same sequence for same seed on every platform
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+rnd (int n)
+{
+    rnd_state = rnd_state * 1103515245UL + 12345;
+    return (rnd_state >> 16) % n;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: random color of init_pair(): default, 8 colors, palette of terminal or 24 bit
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int32_t
+rnd_color (void)
+{
+    switch (rnd (4))
+    {
+        case 0:     return COLOR_DEFAULT;
+        case 1:     return rnd (8);
+        case 2:     return rnd (256);
+        default:    return COLOR_RGB (rnd (256), rnd (256), rnd (256));
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: set random colors of pair, remember them for the shadow screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+sh_init_pair (uint8_t pair)
+{
+    sh_pairs[pair][0] = rnd_color ();
+    sh_pairs[pair][1] = rnd_color ();
+    (void) init_pair (pair, sh_pairs[pair][0], sh_pairs[pair][1]);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: rendition a terminal should show for attribute attr
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+sh_rendition (uint16_t attr, VT_CELL * r)
+{
+    r->flags = attr & A_FLAGS;
+
+    if (attr & A_COLORPAIR)
+    {
+        r->fg = sh_pairs[attr >> 8][0];
+        r->bg = sh_pairs[attr >> 8][1];
+    }
+    else                                                                        // F_xxx, B_xxx: color + 1, 0 = default
+    {
+        r->fg = (int32_t) ((attr & F_COLOR) >> 8) - 1;
+        r->bg = (int32_t) ((attr & B_COLOR) >> 12) - 1;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: check if model cell looks like shadow cell. Of a blank only background, reverse and underline are visible.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+sh_same (const VT_CELL * c, const chtype * s)
+{
+    VT_CELL r;
+
+    sh_rendition (s->attr, &r);
+
+    if (c->ch != s->ch || c->bg != r.bg)
+    {
+        return FALSE;
+    }
+
+    if (c->ch == ' ')
+    {
+        return (c->flags & (A_REVERSE | A_UNDERLINE)) == (r.flags & (A_REVERSE | A_UNDERLINE)) && (! (r.flags & A_REVERSE) || c->fg == r.fg);
+    }
+    return c->flags == r.flags && c->fg == r.fg;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: put cells of a rectangle on the shadow screen, the rectangle ends at the edges of the screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+sh_fill (int y, int x, int nlines, int ncols, uint8_t ch, uint16_t attr)
+{
+    int     i;
+
+    for ( ; nlines > 0 && y < LINES; nlines--, y++)
+    {
+        for (i = 0; i < ncols && x + i < COLS; i++)
+        {
+            sh_screen[y][x + i].ch      = ch;
+            sh_screen[y][x + i].attr    = attr;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: one random call of the library, same change on the shadow screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+test_random_call (void)
+{
+    static chtype   buf[LINES][COLS];
+    char            str[COLS];
+    WINDOW *        win;
+    uint8_t         ch = test_chars[rnd (sizeof (test_chars) - 1)];
+    int             y = rnd (LINES);
+    int             x = rnd (COLS);
+    int             h = 1 + rnd (8);
+    int             w = 1 + rnd (30);
+    int             dsty;
+    int             dstx;
+    int             i;
+    int             j;
+
+    switch (rnd (14))
+    {
+        case 0: case 1: case 2:                                                 // text
+            if (w > COLS - x)
+            {
+                w = COLS - x;
+            }
+
+            for (i = 0; i < w; i++)
+            {
+                str[i] = test_chars[rnd (sizeof (test_chars) - 1)];
+            }
+            sh_fill (y, x, 1, w, ' ', sh_attr);
+
+            for (i = 0; i < w; i++)
+            {
+                sh_screen[y][x + i].ch = str[i];
+            }
+            mvaddnstr (y, x, str, w);
+            break;
+        case 3:
+            sh_attr = test_attrs[rnd (sizeof (test_attrs) / sizeof (test_attrs[0]))];
+            attrset (sh_attr);
+            break;
+        case 4:
+            fillrect (y, x, h, w, ch);
+            sh_fill (y, x, h, w, ch, sh_attr);
+            break;
+        case 5:
+            eraserect (y, x, h, w);
+            sh_fill (y, x, h, w, ' ', ATTR_BG (sh_attr));
+            break;
+        case 6: case 7:
+            dsty = rnd (LINES);
+            dstx = rnd (COLS);
+
+            if (copyrect (y, x, h, w, dsty, dstx) == OK)
+            {
+                for (i = 0; i < h && y + i < LINES && dsty + i < LINES; i++)
+                {
+                    for (j = 0; j < w && x + j < COLS && dstx + j < COLS; j++)
+                    {
+                        buf[i][j] = sh_screen[y + i][x + j];
+                    }
+                }
+
+                for (i = 0; i < h && y + i < LINES && dsty + i < LINES; i++)
+                {
+                    for (j = 0; j < w && x + j < COLS && dstx + j < COLS; j++)
+                    {
+                        sh_screen[dsty + i][dstx + j] = buf[i][j];
+                    }
+                }
+            }
+            break;
+        case 8:                                                                 // ICH or DCH
+            move (y, x);
+
+            if (rnd (2))
+            {
+                insch (ch);
+                memmove (sh_screen[y] + x + 1, sh_screen[y] + x, (COLS - x - 1) * sizeof (chtype));
+                sh_fill (y, x, 1, 1, ch, sh_attr);
+            }
+            else
+            {
+                delch ();
+                memmove (sh_screen[y] + x, sh_screen[y] + x + 1, (COLS - x - 1) * sizeof (chtype));
+                sh_fill (y, COLS - 1, 1, 1, ' ', ATTR_BG (sh_attr));
+            }
+            break;
+        case 9:                                                                 // REP, if enabled
+            ch = rnd (2) ? ch : 0;
+            move (y, x);
+            hline (ch, w);
+            sh_fill (y, x, 1, w, ch ? ch : ACS_HLINE, sh_attr);
+            break;
+        case 10:
+            if (y + h > LINES)
+            {
+                h = LINES - y;
+            }
+
+            if (x + w > COLS)
+            {
+                w = COLS - x;
+            }
+
+            win = newwin (h, w, y, x);
+
+            if (win)
+            {
+                werase (win);
+                delwin (win);
+                sh_fill (y, x, h, w, ' ', ATTR_BG (sh_attr));
+            }
+            break;
+        case 11:                                                                // narrow window: margins or copy
+            if (y + h > LINES)
+            {
+                h = LINES - y;
+            }
+
+            if (rnd (4) == 0)                                                   // sometimes full width
+            {
+                x = 0;
+                w = COLS;
+            }
+            else if (x + w > COLS)
+            {
+                w = COLS - x;
+            }
+
+            win = newwin (h, w, y, x);
+            i = rnd (2) ? 1 + rnd (3) : -1 - rnd (3);
+
+            if (win && wscrl (win, i) == OK)
+            {
+                for (j = 0; j < h; j++)
+                {
+                    if (j + i >= 0 && j + i < h)
+                    {
+                        memcpy (buf[j], sh_screen[y + j + i] + x, w * sizeof (chtype));
+                    }
+                    else
+                    {
+                        for (dstx = 0; dstx < w; dstx++)
+                        {
+                            buf[j][dstx].ch     = ' ';
+                            buf[j][dstx].attr   = ATTR_BG (sh_attr);
+                        }
+                    }
+                }
+
+                for (j = 0; j < h; j++)
+                {
+                    memcpy (sh_screen[y + j] + x, buf[j], w * sizeof (chtype));
+                }
+            }
+            delwin (win);
+            break;
+        case 12:
+            refresh ();
+            break;
+        case 13:                                                                // recolor cells on screen
+#if MCURSES_VIRTUAL_SCREEN
+            sh_init_pair (1 + rnd (COLORS));
+#endif
+            break;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: compare model screen with shadow screen, virtual screen too
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_compare (const char * name, uint32_t seed, int caps, chtype (* vs)[COLS])
+{
+    char    have[4 * COLS + 1];
+    char    want[4 * COLS + 1];
+    char *  p;
+    char *  q;
+    VT_CELL r;
+    int     y;
+    int     x;
+    int     col;
+
+    for (y = 0; y < LINES; y++)
+    {
+        for (col = 0; col < COLS; col++)
+        {
+            if (vs ? (vs[y][col].ch != sh_screen[y][col].ch || (vs[y][col].ch != ' ' && vs[y][col].attr != sh_screen[y][col].attr))
+                   : ! sh_same (&vt_screen[y][col], &sh_screen[y][col]))
+            {
+                break;
+            }
+        }
+
+        if (col < COLS)
+        {
+            p = have;
+            q = want;
+
+            for (x = 0; x < COLS; x++)
+            {
+                p = test_utf8 (p, vs ? vs[y][x].ch : vt_screen[y][x].ch);
+                q = test_utf8 (q, sh_screen[y][x].ch);
+            }
+            *p = '\0';
+            *q = '\0';
+
+            fprintf (stderr, "%s (seed %u, caps %d): %s line %d differs\n  got      \"%s\"\n  expected \"%s\"\n",
+                     name, seed, caps, vs ? "virtual screen" : "terminal", y, have, want);
+
+            if (! vs)
+            {
+                sh_rendition (sh_screen[y][col].attr, &r);
+                fprintf (stderr, "  column %d: flags 0x%02x fg %ld bg %ld, expected flags 0x%02x fg %ld bg %ld\n", col,
+                         vt_screen[y][col].flags, (long) vt_screen[y][col].fg, (long) vt_screen[y][col].bg, r.flags, (long) r.fg, (long) r.bg);
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: random rectangle, character shift, REP and scroll calls, compare terminal with shadow screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_random_calls (FILE * fp)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    static chtype   vs[LINES][COLS];
+#endif
+    MCURSES_STATS   st;
+    uint32_t        bytes[CAPS];
+    uint32_t        seed;
+    int             caps;
+    int             errors = 0;
+    int             i;
+
+    for (caps = 0; caps < CAPS; caps++)
+    {
+        bytes[caps] = 0;
+
+        for (seed = 1; seed <= SEEDS; seed++)
+        {
+            test_begin (fp);
+            rectoutput ((caps & CAP_RECT) ? TRUE : FALSE);
+            repoutput ((caps & CAP_REP) ? TRUE : FALSE);
+            marginoutput ((caps & CAP_MARGINS) ? TRUE : FALSE);
+            clearstats ();
+
+            rnd_state = seed;
+            sh_attr = A_NORMAL;
+            sh_pairs[0][0] = COLOR_DEFAULT;
+            sh_pairs[0][1] = COLOR_DEFAULT;
+
+            for (i = 1; i <= COLORS; i++)
+            {
+                sh_init_pair (i);
+            }
+            sh_fill (0, 0, LINES, COLS, ' ', A_NORMAL);
+
+            for (i = 0; i < OPS; i++)
+            {
+                test_random_call ();
+            }
+            refresh ();
+            getstats (&st);
+            bytes[caps] += st.bytes;
+
+#if MCURSES_VIRTUAL_SCREEN
+            for (i = 0; i < LINES; i++)
+            {
+                move (i, 0);
+                (void) inchnstr (vs[i], COLS);
+            }
+            errors += test_compare ("test_random_calls", seed, caps, vs);
+#endif
+            test_end (fp, 0);
+            sh_fill (LINES - 1, 0, 1, COLS, ' ', ATTR_BG (sh_attr));            // endwin() clears last line
+            errors += test_compare ("test_random_calls", seed, caps, (chtype (*)[COLS]) 0);
+        }
+    }
+
+#if MCURSES_VIRTUAL_SCREEN                                                      // same calls: rectangle ops and margins must save bytes
+    for (caps = 0; caps < CAPS; caps++)
+    {
+        if ((caps & CAP_RECT) && bytes[caps] >= bytes[caps & ~CAP_RECT])
+        {
+            fprintf (stderr, "test_random_calls: %u bytes with rectangle ops, %u without\n", bytes[caps], bytes[caps & ~CAP_RECT]);
+            errors++;
+        }
+
+        if ((caps & CAP_MARGINS) && bytes[caps] >= bytes[caps & ~CAP_MARGINS])
+        {
+            fprintf (stderr, "test_random_calls: %u bytes with margins, %u without\n", bytes[caps], bytes[caps & ~CAP_MARGINS]);
+            errors++;
+        }
+    }
+#endif
+    repoutput (FALSE);
+    rectoutput (FALSE);
+    marginoutput (FALSE);
+    return errors;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: random rows of cells with addchnstr() and with an attrset()/addch() loop, both must show the same
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_addchnstr (FILE * fp)
+{
+    static chtype   row[COLS];
+    MCURSES_STATS   st;
+    uint32_t        bytes[2];
+    uint32_t        seed;
+    uint16_t        attr;
+    int             loop;
+    int             errors = 0;
+    int             y;
+    int             x;
+
+    bytes[0] = 0;
+    bytes[1] = 0;
+
+    for (seed = 1; seed <= SEEDS; seed++)
+    {
+        for (loop = 0; loop < 2; loop++)
+        {
+            test_begin (fp);
+            clearstats ();
+
+            rnd_state = seed;
+            sh_pairs[0][0] = COLOR_DEFAULT;
+            sh_pairs[0][1] = COLOR_DEFAULT;
+
+            for (x = 1; x <= COLORS; x++)
+            {
+                sh_init_pair (x);
+            }
+
+            attr = A_NORMAL;
+
+            for (y = 0; y < LINES - 1; y++)
+            {
+                for (x = 0; x < COLS; x++)
+                {
+                    if (rnd (4) == 0)                                           // runs of equal attributes
+                    {
+                        attr = test_attrs[rnd (sizeof (test_attrs) / sizeof (test_attrs[0]))];
+                    }
+                    row[x].ch   = test_chars[rnd (sizeof (test_chars) - 1)];
+                    row[x].attr = attr;
+                    sh_screen[y][x] = row[x];
+                }
+
+                move (y, 0);
+
+                if (loop)
+                {
+                    for (x = 0; x < COLS; x++)
+                    {
+                        attrset (row[x].attr);
+                        addch (row[x].ch);
+                    }
+                    attrset (A_NORMAL);
+                    move (y, 0);                                                // addchnstr(): cursor stays
+                }
+                else
+                {
+                    addchnstr (row, COLS);
+                }
+            }
+            refresh ();
+            getstats (&st);
+            bytes[loop] += st.bytes;
+
+            test_end (fp, 0);
+            sh_fill (LINES - 1, 0, 1, COLS, ' ', A_NORMAL);                     // endwin() clears last line
+            errors += test_compare (loop ? "test_addchnstr (loop)" : "test_addchnstr", seed, 0, (chtype (*)[COLS]) 0);
+        }
+    }
+
+#if ! MCURSES_VIRTUAL_SCREEN                                                    // SGR only where the attribute changes
+    if (bytes[0] > bytes[1])
+    {
+        fprintf (stderr, "test_addchnstr: %u bytes with addchnstr(), %u with loop\n", bytes[0], bytes[1]);
+        errors++;
+    }
+#endif
+    return errors;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: two log panes side by side, scrolled by redraw, by DECCRA copy and by margins
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_log_panes (FILE * fp)
+{
+    static const int    caps[3] = { 0, CAP_RECT, CAP_MARGINS };
+    MCURSES_STATS       st;
+    MCURSES_LOG *       log[2];
+    WINDOW *            win[2];
+    uint32_t            bytes[3];
+    char                buf[20];
+    int                 errors = 0;
+    int                 i;
+    int                 m;
+
+    for (m = 0; m < 3; m++)
+    {
+        test_begin (fp);
+        rectoutput ((caps[m] & CAP_RECT) ? TRUE : FALSE);
+        marginoutput ((caps[m] & CAP_MARGINS) ? TRUE : FALSE);
+        clearstats ();
+
+        win[0] = newwin (LINES - 1, COLS / 2, 0, 0);
+        win[1] = newwin (LINES - 1, COLS / 2, 0, COLS / 2);
+        log[0] = newlog (win[0]);
+        log[1] = newlog (win[1]);
+
+        if (! win[0] || ! win[1] || ! log[0] || ! log[1])
+        {
+            endwin ();
+            fprintf (stderr, "test_log_panes: out of memory\n");
+            return 1;
+        }
+
+        for (i = 0; i < 500; i++)
+        {
+            sprintf (buf, "left %d", i);
+            logaddstr (log[0], buf);
+            logdraw (log[0]);
+            sprintf (buf, "right %d", i);
+            logaddstr (log[1], buf);
+            logdraw (log[1]);
+            refresh ();
+        }
+
+        getstats (&st);
+        bytes[m] = st.bytes;
+        test_end (fp, 0);
+
+        errors += expect (0, 0, "left 477 ");
+        errors += expect (0, COLS / 2, "right 477 ");
+        errors += expect (LINES - 2, 0, "left 499 ");
+        errors += expect (LINES - 2, COLS / 2, "right 499 ");
+
+        for (i = 0; i < 2; i++)
+        {
+            dellog (log[i]);
+            delwin (win[i]);
+        }
+    }
+
+    if (bytes[1] >= bytes[0] || bytes[2] >= bytes[1])                           // redraw > copy > margins
+    {
+        fprintf (stderr, "test_log_panes: redraw %u, copy %u, margins %u bytes\n", bytes[0], bytes[1], bytes[2]);
+        errors++;
+    }
+    rectoutput (FALSE);
+    marginoutput (FALSE);
+
+    if (errors)
+    {
+        fprintf (stderr, "test_log_panes failed\n");
+    }
+    return errors;
+}
+
+#if MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: frame of more than 64 KB: checkerboard of two truecolor pairs with alternating attributes
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_large_frame (FILE * fp)
+{
+    MCURSES_STATS   st;
+    uint32_t        bytes;
+    int             errors = 0;
+    int             y;
+    int             x;
+
+    test_begin (fp);
+    init_pair (1, COLOR_RGB (255, 128, 0), COLOR_RGB (0, 64, 128));
+    init_pair (2, COLOR_RGB (0, 128, 255), COLOR_RGB (128, 64, 0));
+    refresh ();
+    getstats (&st);
+    bytes = st.bytes;
+
+    for (y = 0; y < LINES; y++)
+    {
+        move (y, 0);
+
+        for (x = 0; x < COLS; x++)
+        {
+            attrset (((x + y) & 1) ? COLOR_PAIR(1) | A_BOLD | A_UNDERLINE : COLOR_PAIR(2) | A_REVERSE | A_BLINK);
+            addch ('#');
+        }
+    }
+    refresh ();
+    getstats (&st);
+    test_end (fp, 0);
+
+    errors += expect (0, 0, "##########");
+
+    if (st.last_bytes != st.bytes - bytes || st.last_bytes <= 0xFFFF)
+    {
+        fprintf (stderr, "test_large_frame: last frame %u bytes, sent %u bytes\n", st.last_bytes, st.bytes - bytes);
+        errors++;
+    }
+    return errors;
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: slow terminal, copies output from pipe to file
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void *
+test_slow_terminal (void * arg)
+{
+    char    buf[SLOW_BLOCK];
+    ssize_t n;
+
+    (void) arg;
+
+    while ((n = read (slow_fd, buf, sizeof (buf))) > 0)
+    {
+        fwrite (buf, 1, n, slow_fp);
+        usleep (SLOW_USECS);
+    }
+    return (void *) 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * TEST: random calls with ASYNC_THREAD output to a slow terminal, with coalescing of frames and statistics read and
+ * cleared by the main thread while the helper thread measures the throughput. Build with make -f Makefile.unix tsan
+ * to check for data races.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+test_async (FILE * fp)
+{
+    MCURSES_STATS   st;
+    pthread_t       reader;
+    uint32_t        skipped = 0;
+    int             fd[2];
+    int             saved;
+    int             errors = 0;
+    int             i;
+
+    rewind (fp);
+    (void) ftruncate (fileno (fp), 0);
+    fflush (stdout);
+
+    if ((saved = dup (fileno (stdout))) < 0 || pipe (fd) < 0 || dup2 (fd[1], fileno (stdout)) < 0)
+    {
+        perror ("pipe");
+        return 1;
+    }
+    close (fd[1]);
+
+    slow_fd = fd[0];
+    slow_fp = fp;
+
+    if (pthread_create (&reader, (pthread_attr_t *) 0, test_slow_terminal, (void *) 0) != 0)
+    {
+        perror ("pthread_create");
+        return 1;
+    }
+
+    initscr ();
+    asyncoutput (ASYNC_THREAD);
+#if MCURSES_VIRTUAL_SCREEN
+    coalesce (TRUE);
+#endif
+
+    rnd_state = 1;
+    sh_attr = A_NORMAL;
+    sh_pairs[0][0] = COLOR_DEFAULT;
+    sh_pairs[0][1] = COLOR_DEFAULT;
+
+    for (i = 1; i <= COLORS; i++)
+    {
+        sh_init_pair (i);
+    }
+    sh_fill (0, 0, LINES, COLS, ' ', A_NORMAL);
+
+    for (i = 0; i < ASYNC_OPS; i++)
+    {
+        test_random_call ();
+        refresh ();
+        getstats (&st);
+
+        if (i % 100 == 99)
+        {
+            skipped += st.skipped;
+            clearstats ();
+        }
+    }
+    doupdate ();                                                                // send last frame, even if coalesced
+#if MCURSES_VIRTUAL_SCREEN
+    coalesce (FALSE);
+#endif
+    endwin ();                                                                  // writes rest of queue
+    fflush (stdout);
+
+    dup2 (saved, fileno (stdout));                                              // close pipe: end of reader
+    close (saved);
+    pthread_join (reader, (void **) 0);
+    close (slow_fd);
+
+    fflush (fp);
+    rewind (fp);
+    vt_onlcr = 0;
+    vt_play (fp);
+
+    sh_fill (LINES - 1, 0, 1, COLS, ' ', ATTR_BG (sh_attr));                    // endwin() clears last line
+    errors += test_compare ("test_async", 1, 0, (chtype (*)[COLS]) 0);
+
+#if MCURSES_VIRTUAL_SCREEN
+    if (skipped == 0)
+    {
+        fprintf (stderr, "test_async: no frame coalesced\n");
+        errors++;
+    }
+#endif
+    return errors;
+}
+
+int
+main (void)
+{
+    FILE *  fp;
+    int     errors = 0;
+
+    fp = tmpfile ();
+
+    if (! fp || dup2 (fileno (fp), fileno (stdout)) < 0)
+    {
+        perror ("tmpfile");
+        return 1;
+    }
+
+    errors += test_termcaps (fp);
+    errors += test_lf_scroll (fp, 0);
+    errors += test_lf_scroll (fp, 1);
+#if MCURSES_VIRTUAL_SCREEN
+    errors += test_panel (fp);
+#endif
+    errors += test_utf8_widgets (fp);
+    errors += test_wide (fp, 0);
+    errors += test_wide (fp, CAP_RECT | CAP_MARGINS);
+    errors += test_random_calls (fp);
+    errors += test_addchnstr (fp);
+    errors += test_log_panes (fp);
+#if MCURSES_VIRTUAL_SCREEN
+    errors += test_large_frame (fp);
+#endif
+    errors += test_async (fp);
+
+#if MCURSES_VIRTUAL_SCREEN
+    fprintf (stderr, "%s\n", errors ? "FAILED" : "OK");
+#else
+    fprintf (stderr, "%s (immediate mode)\n", errors ? "FAILED" : "OK");
+#endif
+    return errors ? 1 : 0;
+}
@@ -13,17 +13,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 
 #ifdef unix
 #include <termio.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #define PROGMEM
 #define PSTR(x)                                 (x)
 #define pgm_read_byte(s)                        (*s)
+#define pgm_read_word(s)                        (*s)
 #elif (defined __SDCC_z80)
 #define PROGMEM
 #define PSTR(x)                                 (x)
 #define pgm_read_byte(s)                        (*s)
+#define pgm_read_word(s)                        (*s)
 #else // AVR
 #include <avr/io.h>
 #include <avr/pgmspace.h>
@@ -37,28 +45,83 @@
 #define SEQ_CLRTOBOT                            PSTR("\033[J")                  // clear to bottom
 #define SEQ_CLRTOEOL                            PSTR("\033[K")                  // clear to end of line
 #define SEQ_DELCH                               PSTR("\033[P")                  // delete character
-#define SEQ_NEXTLINE                            PSTR("\033E")                   // goto next line (scroll up at end of scrolling region)
-#define SEQ_INSERTLINE                          PSTR("\033[L")                  // insert line
-#define SEQ_DELETELINE                          PSTR("\033[M")                  // delete line
 #define SEQ_ATTRSET                             PSTR("\033[0")                  // set attributes, e.g. "\033[0;7;1m"
 #define SEQ_ATTRSET_REVERSE                     PSTR(";7")                      // reverse
 #define SEQ_ATTRSET_UNDERLINE                   PSTR(";4")                      // underline
 #define SEQ_ATTRSET_BLINK                       PSTR(";5")                      // blink
 #define SEQ_ATTRSET_BOLD                        PSTR(";1")                      // bold
 #define SEQ_ATTRSET_DIM                         PSTR(";2")                      // dim
-#define SEQ_ATTRSET_FCOLOR                      PSTR(";3")                      // forground color
-#define SEQ_ATTRSET_BCOLOR                      PSTR(";4")                      // background color
+#define SEQ_ATTRSET_NORMAL                      PSTR(";22")                     // neither bold nor dim
+#define SEQ_ATTRSET_NO_UNDERLINE                PSTR(";24")                     // underline off
+#define SEQ_ATTRSET_NO_BLINK                    PSTR(";25")                     // blink off
+#define SEQ_ATTRSET_NO_REVERSE                  PSTR(";27")                     // reverse off
+#define SEQ_ATTRSET_FDEFAULT                    PSTR(";39")                     // default foreground color
+#define SEQ_ATTRSET_BDEFAULT                    PSTR(";49")                     // default background color
 #define SEQ_INSERT_MODE                         PSTR("\033[4h")                 // set insert mode
 #define SEQ_REPLACE_MODE                        PSTR("\033[4l")                 // set replace mode
 #define SEQ_RESET_SCRREG                        PSTR("\033[r")                  // reset scrolling region
+#define SEQ_SAVE_CURSOR                         PSTR("\0337")                   // DECSC: save cursor position
+#define SEQ_RESTORE_CURSOR                      PSTR("\0338")                   // DECRC: restore cursor position
 #define SEQ_LOAD_G1                             PSTR("\033)0")                  // load G1 character set
 #define SEQ_CURSOR_VIS                          PSTR("\033[?25")                // set cursor visible/not visible
+#define SEQ_SYNC_BEGIN                          PSTR("\033[?2026h")             // begin synchronized update (DEC mode 2026)
+#define SEQ_SYNC_END                            PSTR("\033[?2026l")             // end synchronized update
+#define SEQ_SYNC_QUERY                          PSTR("\033[?2026$p")            // DECRQM: request state of DEC mode 2026
+#define SEQ_DA_QUERY                            PSTR("\033[c")                  // DA1: request primary device attributes
+#define SEQ_MARGINS_QUERY                       PSTR("\033[?69$p")              // DECRQM: request state of DEC mode 69 (DECLRMM)
+#define SEQ_MARGINS_ON                          PSTR("\033[?69h")               // DECLRMM: allow left/right margins
+#define SEQ_MARGINS_OFF                         PSTR("\033[?69l")               // DECLRMM off
+#define SEQ_RESET_MARGINS                       PSTR("\033[s")                  // DECSLRM: reset left/right margins
+
+#define TERMCAP_SYNC                            0x01                            // terminal reported support of DEC mode 2026
+#define TERMCAP_RECT                            0x02                            // terminal reported rectangular editing (DA1 extension 28)
+#define TERMCAP_MARGINS                         0x04                            // terminal reported support of DEC mode 69 (DECLRMM)
 
 static uint8_t                                  mcurses_scrl_start = 0;         // start of scrolling region, default is 0
 static uint8_t                                  mcurses_scrl_end = LINES - 1;   // end of scrolling region, default is last line
 static uint8_t                                  mcurses_nodelay;                // nodelay flag
+static uint8_t                                  mcurses_sync;                   // synchronized output flag
+static uint8_t                                  mcurses_sync_frame;             // flag: begin of synchronized update already sent
+static uint8_t                                  mcurses_termcaps;               // capabilities reported by terminal, see TERMCAP_xxx
+#if ! MCURSES_UNICODE_ACS
+static uint8_t                                  mcurses_charset = 0xff;         // current character set of terminal: G0 or G1
+#endif
+static uint8_t                                  mcurses_insert_mode;            // insert mode of terminal
+static uint8_t                                  mcurses_rep;                    // flag: terminal repeats characters (REP), see repoutput()
+static uint8_t                                  mcurses_rect;                   // flag: use rectangular area operations, see rectoutput()
+static uint8_t                                  mcurses_margins;                // flag: use left/right margins, see marginoutput()
+static uint8_t                                  mcurses_lrmm;                   // flag: DECLRMM set in terminal
+static uint8_t                                  mcurses_phys_top = 0xff;        // scrolling region of terminal (DECSTBM), 0xff = unknown
+static uint8_t                                  mcurses_phys_bottom = 0xff;
+#if MCURSES_VIRTUAL_SCREEN
+static uint8_t                                  mcurses_coalesce;               // flag: skip frames while output is busy
+static uint8_t                                  mcurses_dry;                    // flag: count bytes only, don't send
+static uint32_t                                 mcurses_dry_bytes;              // counted bytes
+#else
+static uint16_t                                 mcurses_attr;                   // current attributes, see attrset()
+#endif
+static uint8_t                                  mcurses_frame_pending;          // flag: frame skipped, send it if output is drained
+static uint8_t                                  mcurses_frame_blocked;          // flag: frame skipped because output is busy
 uint8_t                                         mcurses_cury;                   // current y position of cursor, public (getyx())
 uint8_t                                         mcurses_curx;                   // current x position of cursor, public (getyx())
+static MCURSES_STATS                            mcurses_stats;                  // statistics, see getstats()
+static uint32_t                                 mcurses_throughput = MCURSES_BAUD / 10;     // estimated throughput in bytes/sec
+static uint32_t                                 mcurses_frame_bytes;            // value of mcurses_stats.bytes at end of last frame
+
+static uint8_t                                  mcurses_output_idle (void);
+
+#if defined(unix)                                                               // shared with drain thread, see mcurses_outq_measure()
+#define SHARED_LOAD(v)                          __atomic_load_n (&(v), __ATOMIC_RELAXED)
+#define SHARED_STORE(v,x)                       __atomic_store_n (&(v), (x), __ATOMIC_RELAXED)
+#else
+#define SHARED_LOAD(v)                          (v)
+#define SHARED_STORE(v,x)                       ((v) = (x))
+#endif
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
+static uint16_t                                 mcurses_frame_period;           // min. milliseconds between two frames, see refreshrate()
+static uint32_t                                 mcurses_frame_next;             // time of next frame in milliseconds
+static int                                      mcurses_refresh_delay (void);
+#endif
 
 #if defined(unix)
 
@@ -69,6 +132,325 @@ uint8_t                                         mcurses_curx;
 static struct termio                            mcurses_oldmode;
 static struct termio                            mcurses_newmode;
 
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: asynchronous output queue for UNIX or LINUX
+ *
+ * If asyncoutput() is set, mcurses_phyio_putc() stores the characters in a ringbuffer and refresh() returns at once. The
+ * ringbuffer is drained on a non-blocking fd by the application (poll outfd() for POLLOUT, then call outdrain()) or by a
+ * helper thread. There is exactly one producer (mcurses) and one consumer (drain), so head and tail need no lock.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#define OUTQ_MASK                               (MCURSES_OUTQ_SIZE - 1)         // MCURSES_OUTQ_SIZE must be a power of 2
+
+static uint8_t                                  mcurses_outq[MCURSES_OUTQ_SIZE];// output ringbuffer
+static uint32_t                                 mcurses_outq_head;              // consumer: next character to write
+static uint32_t                                 mcurses_outq_tail;              // producer: end of published characters
+static uint32_t                                 mcurses_outq_fill;              // producer: end of stored characters
+static uint8_t                                  mcurses_async;                  // ASYNC_OFF, ASYNC_POLL or ASYNC_THREAD
+static int                                      mcurses_outfd = -1;             // non-blocking output fd
+static int                                      mcurses_outfd_flags;            // original fd flags, if fd is stdout
+static uint8_t                                  mcurses_outfd_opened;           // TRUE: fd opened by us, close it at the end
+static pthread_t                                mcurses_drain_thread;           // helper thread for ASYNC_THREAD
+static pthread_mutex_t                          mcurses_outq_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t                           mcurses_outq_cond = PTHREAD_COND_INITIALIZER;
+static uint8_t                                  mcurses_drain_stop;             // flag: helper thread should stop
+static uint8_t                                  mcurses_tp_busy;                // flag: output fd saturated at last write
+static uint32_t                                 mcurses_tp_last;                // time of last write in microseconds
+static uint32_t                                 mcurses_tp_time;                // saturated time of current sample in microseconds
+static uint32_t                                 mcurses_tp_bytes;               // bytes written in saturated time
+
+#if MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return monotonic clock in milliseconds
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_phyio_msecs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return monotonic clock in microseconds
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_phyio_usecs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: measure throughput of output fd: bytes written per second while the fd is saturated, i.e. output is
+ * pending or a frame waits for the output to drain
+ *
+ * Runs on the consumer side, with ASYNC_THREAD in the helper thread. The mcurses_tp_xxx variables belong to the
+ * consumer, mcurses_throughput and mcurses_frame_blocked are shared with mcurses and accessed atomically.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_outq_measure (uint32_t written, uint8_t busy)
+{
+    uint32_t    now = mcurses_phyio_usecs ();
+    uint64_t    rate;
+
+    if (mcurses_tp_busy)                                                        // saturated since last call?
+    {                                                                           // yes, add bytes and time
+        mcurses_tp_bytes += written;
+        mcurses_tp_time  += now - mcurses_tp_last;
+
+        if (mcurses_tp_time >= 100000)                                          // enough for a sample (100 msec)
+        {
+            rate = (uint64_t) mcurses_tp_bytes * 1000000 / mcurses_tp_time;
+            rate = (3 * (uint64_t) SHARED_LOAD (mcurses_throughput) + rate) / 4;    // smooth it
+            SHARED_STORE (mcurses_throughput, (rate > 0) ? (uint32_t) rate : 1);
+            mcurses_tp_bytes = 0;
+            mcurses_tp_time  = 0;
+        }
+    }
+
+    mcurses_tp_busy = busy;
+    mcurses_tp_last = now;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: write as many published characters as possible without blocking, return number of characters still pending
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_outq_write (void)
+{
+    uint32_t    head = __atomic_load_n (&mcurses_outq_head, __ATOMIC_RELAXED);
+    uint32_t    tail = __atomic_load_n (&mcurses_outq_tail, __ATOMIC_ACQUIRE);
+    uint32_t    start = head;
+    uint32_t    off;
+    uint32_t    len;
+    ssize_t     n;
+
+    while (head != tail)
+    {
+        off = head & OUTQ_MASK;
+        len = tail - head;
+
+        if (len > MCURSES_OUTQ_SIZE - off)                                      // don't write across end of ringbuffer
+        {
+            len = MCURSES_OUTQ_SIZE - off;
+        }
+
+        n = write (mcurses_outfd, mcurses_outq + off, len);
+
+        if (n > 0)
+        {
+            head += n;
+            __atomic_store_n (&mcurses_outq_head, head, __ATOMIC_RELEASE);
+        }
+        else if (n < 0 && errno == EINTR)
+        {
+            ;                                                                   // interrupted, try again
+        }
+        else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {                                                                       // fd is dead, e.g. hangup:
+            head = tail;                                                        // throw output away, nobody can see it
+            __atomic_store_n (&mcurses_outq_head, head, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            break;                                                              // fd not writable, try later
+        }
+    }
+
+    mcurses_outq_measure (head - start, head != tail || SHARED_LOAD (mcurses_frame_blocked));
+    return tail - head;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: wait until output fd is writable
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_outq_wait (int timeout)
+{
+    struct pollfd   pfd;
+
+    pfd.fd      = mcurses_outfd;
+    pfd.events  = POLLOUT;
+    (void) poll (&pfd, 1, timeout);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: publish stored characters to consumer
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_outq_publish (void)
+{
+    __atomic_store_n (&mcurses_outq_tail, mcurses_outq_fill, __ATOMIC_RELEASE);
+
+    if (mcurses_async == ASYNC_THREAD)
+    {
+        pthread_mutex_lock (&mcurses_outq_mutex);
+        pthread_cond_broadcast (&mcurses_outq_cond);                            // wake up helper thread
+        pthread_mutex_unlock (&mcurses_outq_mutex);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return number of characters in output queue
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_outq_pending (void)
+{
+    return mcurses_outq_fill - __atomic_load_n (&mcurses_outq_head, __ATOMIC_ACQUIRE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: wait until output queue has space for at least one character (backpressure)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_outq_wait_space (void)
+{
+    mcurses_outq_publish ();
+
+    while (mcurses_outq_pending () >= MCURSES_OUTQ_SIZE)
+    {
+        if (mcurses_async == ASYNC_THREAD)
+        {
+            pthread_mutex_lock (&mcurses_outq_mutex);
+
+            if (mcurses_outq_pending () >= MCURSES_OUTQ_SIZE)
+            {
+                pthread_cond_wait (&mcurses_outq_cond, &mcurses_outq_mutex);    // helper thread signals progress
+            }
+            pthread_mutex_unlock (&mcurses_outq_mutex);
+        }
+        else
+        {
+            mcurses_outq_wait (-1);
+            (void) mcurses_outq_write ();
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: helper thread, drains output queue
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void *
+mcurses_drain_main (void * arg)
+{
+    (void) arg;
+
+    pthread_mutex_lock (&mcurses_outq_mutex);
+
+    while (! mcurses_drain_stop)
+    {
+        if (__atomic_load_n (&mcurses_outq_tail, __ATOMIC_ACQUIRE) == mcurses_outq_head)
+        {
+            pthread_cond_wait (&mcurses_outq_cond, &mcurses_outq_mutex);        // nothing to do, wait for publish
+            continue;
+        }
+
+        pthread_mutex_unlock (&mcurses_outq_mutex);
+        mcurses_outq_wait (100);                                                // timeout: check stop flag now and then
+        (void) mcurses_outq_write ();
+        pthread_mutex_lock (&mcurses_outq_mutex);
+        pthread_cond_broadcast (&mcurses_outq_cond);                            // wake up producer waiting for space
+    }
+
+    pthread_mutex_unlock (&mcurses_outq_mutex);
+    return (void *) 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: set asynchronous output mode: ASYNC_OFF, ASYNC_POLL or ASYNC_THREAD
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_phyio_async (uint8_t mode)
+{
+    int     fd;
+    char *  name;
+
+    if (mcurses_async == mode)
+    {
+        return;
+    }
+
+    if (mcurses_async)                                                          // switch off current mode
+    {
+        mcurses_outq_publish ();
+
+        if (mcurses_async == ASYNC_THREAD)
+        {
+            pthread_mutex_lock (&mcurses_outq_mutex);
+            mcurses_drain_stop = TRUE;
+            pthread_cond_broadcast (&mcurses_outq_cond);
+            pthread_mutex_unlock (&mcurses_outq_mutex);
+            pthread_join (mcurses_drain_thread, (void **) 0);
+        }
+
+        while (mcurses_outq_write () > 0)                                       // write rest of queue, blocking
+        {
+            mcurses_outq_wait (-1);
+        }
+
+        if (mcurses_outfd_opened)
+        {
+            close (mcurses_outfd);
+        }
+        else
+        {
+            (void) fcntl (mcurses_outfd, F_SETFL, mcurses_outfd_flags);
+        }
+
+        mcurses_outfd = -1;
+        mcurses_async = ASYNC_OFF;
+    }
+
+    if (mode)
+    {
+        fflush (stdout);
+        fd = fileno (stdout);
+
+        // open the terminal once more: O_NONBLOCK on stdout would also switch stdin, they share the same open file
+        if (isatty (fd) && (name = ttyname (fd)) != (char *) 0 && (mcurses_outfd = open (name, O_WRONLY | O_NONBLOCK | O_NOCTTY)) >= 0)
+        {
+            mcurses_outfd_opened = TRUE;
+        }
+        else
+        {
+            mcurses_outfd           = fd;
+            mcurses_outfd_flags     = fcntl (fd, F_GETFL, 0);
+            mcurses_outfd_opened    = FALSE;
+            (void) fcntl (fd, F_SETFL, mcurses_outfd_flags | O_NONBLOCK);
+        }
+
+        mcurses_outq_head   = 0;
+        mcurses_outq_tail   = 0;
+        mcurses_outq_fill   = 0;
+        mcurses_async       = mode;
+
+        if (mode == ASYNC_THREAD)
+        {
+            mcurses_drain_stop = FALSE;
+
+            if (pthread_create (&mcurses_drain_thread, (pthread_attr_t *) 0, mcurses_drain_main, (void *) 0) != 0)
+            {
+                mcurses_async = ASYNC_POLL;                                     // no thread, application has to drain
+            }
+        }
+    }
+}
+
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * PHYIO: init
  *---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -103,6 +485,8 @@ mcurses_phyio_done (void)
 {
     int     fd;
 
+    mcurses_phyio_async (ASYNC_OFF);                                            // write rest of output queue
+
     fd = fileno (stdin);
 
     (void) ioctl (fd, TCSETAW, &mcurses_oldmode);
@@ -115,7 +499,20 @@ mcurses_phyio_done (void)
 static void
 mcurses_phyio_putc (uint8_t ch)
 {
-    putchar (ch);
+    if (mcurses_async)
+    {
+        if (mcurses_outq_fill - __atomic_load_n (&mcurses_outq_head, __ATOMIC_ACQUIRE) >= MCURSES_OUTQ_SIZE)  // queue full?
+        {                                                                       // yes
+            mcurses_outq_wait_space ();                                         // wait
+        }
+
+        mcurses_outq[mcurses_outq_fill & OUTQ_MASK] = ch;
+        mcurses_outq_fill++;
+    }
+    else
+    {
+        putchar (ch);
+    }
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -125,7 +522,59 @@ mcurses_phyio_putc (uint8_t ch)
 static uint8_t
 mcurses_phyio_getc (void)
 {
-    uint8_t ch;
+    struct pollfd   pfd[2];
+    uint32_t        pending;
+    int             timeout;
+    uint8_t         ch;
+
+    if (! mcurses_nodelay)                                                      // wait for key: keep output moving meanwhile
+    {
+        pfd[0].fd       = fileno (stdin);
+        pfd[0].events   = POLLIN;
+        pfd[1].fd       = mcurses_outfd;
+        pfd[1].events   = POLLOUT;
+
+        while (1)
+        {
+            if (mcurses_async == ASYNC_POLL)
+            {
+                pending = mcurses_outq_write ();
+            }
+            else
+            {
+                pending = mcurses_async ? mcurses_outq_pending () : 0;          // helper thread writes, if any
+            }
+
+            if (mcurses_output_idle ())                                         // skipped frame sent, write it
+            {
+                continue;
+            }
+
+            if (! mcurses_frame_pending && (pending == 0 || mcurses_async != ASYNC_POLL))
+            {
+                break;                                                          // nothing to do but waiting for the key
+            }
+
+            timeout = -1;
+
+#if MCURSES_VIRTUAL_SCREEN
+            if (mcurses_frame_pending)
+            {
+                timeout = mcurses_refresh_delay ();                             // > 0: frame is due later
+
+                if (timeout == 0)                                               // due, but output is busy (coalesce)
+                {
+                    timeout = (mcurses_async == ASYNC_POLL) ? -1 : 10;          // check helper thread every 10 msec
+                }
+            }
+#endif
+
+            if (poll (pfd, (mcurses_async == ASYNC_POLL && pending > 0) ? 2 : 1, timeout) > 0 && (pfd[0].revents & POLLIN))
+            {
+                break;
+            }
+        }
+    }
 
     ch = getchar ();
 
@@ -166,7 +615,29 @@ mcurses_phyio_nodelay (uint8_t flag)
 static void
 mcurses_phyio_flush_output ()
 {
-    fflush (stdout);
+    if (mcurses_async)
+    {
+        mcurses_outq_publish ();
+
+        if (mcurses_async == ASYNC_POLL)
+        {
+            (void) mcurses_outq_write ();                                       // as much as possible without blocking
+        }
+    }
+    else
+    {
+        fflush (stdout);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return number of characters not yet sent
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_phyio_pending (void)
+{
+    return mcurses_async ? mcurses_outq_pending () : 0;
 }
 
 #elif defined (__SDCC_z80)
@@ -236,6 +707,16 @@ mcurses_phyio_flush_output ()
   // leer lassen
 }
 
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return number of characters not yet sent
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_phyio_pending (void)
+{
+    return 0;
+}
+
 #else // AVR
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -495,6 +976,16 @@ mcurses_phyio_flush_output ()
     }
 }
 
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * PHYIO: return number of characters not yet sent
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_phyio_pending (void)
+{
+    return uart_txsize;
+}
+
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * PHYIO: UART interrupt handler, called if UART has received a character
  *---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -556,7 +1047,61 @@ ISR(UART0_UDRE_vect)
 static void
 mcurses_putc (uint8_t ch)
 {
+#if MCURSES_VIRTUAL_SCREEN
+    if (mcurses_dry)                                                            // dry run: count only
+    {
+        mcurses_dry_bytes++;
+        return;
+    }
+#endif
+
+    if (mcurses_sync && (mcurses_termcaps & TERMCAP_SYNC) && ! mcurses_sync_frame)  // confirmed and first character of a new frame?
+    {                                                                           // yes, begin synchronized update
+        const char *    seq = SEQ_SYNC_BEGIN;
+        uint8_t         c;
+
+        while ((c = pgm_read_byte(seq)) != '\0')
+        {
+            mcurses_phyio_putc (c);
+            mcurses_stats.bytes++;
+            seq++;
+        }
+        mcurses_sync_frame = TRUE;
+    }
+
     mcurses_phyio_putc (ch);
+    mcurses_stats.bytes++;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put n characters, each minus offset (raw)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_putn (const char * str, uint8_t n, uint8_t offset)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    if (mcurses_dry)                                                            // dry run: count only
+    {
+        mcurses_dry_bytes += n;
+        return;
+    }
+#endif
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    mcurses_putc (*str++ - offset);                                             // begins synchronized update if necessary
+    n--;
+
+    mcurses_stats.bytes += n;
+
+    while (n--)
+    {
+        mcurses_phyio_putc (*str++ - offset);
+    }
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -604,333 +1149,4684 @@ mcurses_puti (uint8_t i)
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * INTERN: addch or insch a character
+ * INTERN: switch terminal to G0 or G1 character set if necessary, return character to send
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
+#if MCURSES_UNICODE_ACS
+#if ! MCURSES_UTF8
+#error MCURSES_UNICODE_ACS needs MCURSES_UTF8
+#endif
+#define mycharset(ch)   (ch)                                                    // terminal stays in G0, ACS go out as UTF-8
+#else
 #define CHARSET_G0      0
 #define CHARSET_G1      1
 
-static void
-mcurses_addch_or_insch (uint8_t ch, uint8_t insert)
+static uint8_t
+mycharset (uint8_t ch)
 {
-    static uint8_t  charset = 0xff;
-    static uint8_t  insert_mode = FALSE;
-
     if (ch >= 0x80 && ch <= 0x9F)
     {
-        if (charset != CHARSET_G1)
+        if (mcurses_charset != CHARSET_G1)
         {
             mcurses_putc ('\016');                                              // switch to G1 set
-            charset = CHARSET_G1;
+            mcurses_charset = CHARSET_G1;
         }
         ch -= 0x20;                                                             // subtract offset to G1 characters
     }
     else
     {
-        if (charset != CHARSET_G0)
+        if (mcurses_charset != CHARSET_G0)
         {
             mcurses_putc ('\017');                                              // switch to G0 set
-            charset = CHARSET_G0;
+            mcurses_charset = CHARSET_G0;
+        }
+    }
+
+    return ch;
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: characters
+ *
+ * With MCURSES_UTF8 a character is a Unicode code point and goes to the terminal as UTF-8. 0x80-0x9F stay ACS characters
+ * of the G1 set, 0xA0-0xFF are ISO-8859-1, so addch() of a byte shows the same as on an 8 bit terminal. Without
+ * MCURSES_UTF8 a character is a byte, as before.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#if MCURSES_UTF8
+typedef uint32_t                                MCURSES_CHAR;
+
+#define WIDTH(ch)                               (((ch) < 0x300) ? 1 : mcurses_wcwidth (ch))    // no wide or combining characters below 0x300
+#define IS_RUN_CHAR(ch)                         ((uint8_t) (ch) >= 0x20 && (uint8_t) (ch) < 0xA0 && (ch) != 0x7F)  // ASCII or ACS, no UTF-8 lead byte
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: width of characters 0x00000-0x1FFFF, two level table generated from the Unicode 14.0 character database
+ *
+ * mcurses_width_index[] maps each block of 128 characters to one of the distinct blocks in mcurses_width_blocks[], which
+ * hold 2 bits per character: 0 = combining or invisible (Mn, Me, Cf, Hangul medial vowels and final consonants), 1 = normal,
+ * 2 = wide (East Asian Width W or F).
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#define WIDTH_BLOCK                             128                             // characters per block
+
+static const uint8_t                            mcurses_width_index[1024] PROGMEM =
+{
+      0,  0,  0,  0,  0,  0,  1,  2,  0,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
+     26, 27, 28, 29, 30, 31, 32, 33,  0,  0,  0,  0,  0, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46,  0, 47,  0,  0, 48, 49,
+     50, 51,  0, 52,  0,  0, 53, 54, 55,  0,  0, 56, 57, 58, 59, 60,  0,  0,  0,  0,  0,  0, 61, 62,  0, 63, 64, 65, 66, 67, 67, 67,
+     68, 69, 67, 67, 70, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 71, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 72,  0,  0, 73, 74,  0, 75, 76, 77, 78, 79, 80, 81, 82, 83, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 84,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 67, 67, 67, 67, 85, 86,  0,  0,  0, 87, 88, 89, 90, 91,
+     92, 93, 94, 95, 67, 96, 97, 98,  0, 99,100,101,  0,  0,102,103,104,105,106,107,108,109,110,111,112,113,114, 67,115,116,117,118,
+    119,120,121,122,123,124,125, 67,126,127, 67,128,129,130,131, 67,132,133,134,135,136,137, 67, 67,138,139,140,141, 67,142, 67,143,
+      0,  0,  0,  0,  0,  0,  0,144,145,  0,146, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,147,
+      0,  0,  0,  0,  0,  0,  0,  0,148, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67,  0,  0,  0,  0,149, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,  0,  0,  0,  0,150,151,152,153, 67, 67, 67, 67, 71,154,155,156,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,157,158, 67, 67, 67, 67, 67, 67,
+     67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67, 67,159,146,
+      0,160,161,162,163,164,165, 67,166,167,168,  0,  0,169,  0,170,  0,  0,  0,  0,171,172, 67, 67, 67, 67, 67, 67, 67, 67,173, 67,
+    174, 67,175, 67, 67,176, 67, 67, 67, 67, 67, 67, 67, 67, 67,177,  0,178,179, 67, 67, 67, 67, 67,180,181,182, 67,183,184, 67, 67,
+    185,186,  0,187, 67, 67,188,189,190,191,192,193, 72,194,195,196,197,198,199, 67,200, 67,  0,201, 67, 67, 67, 67, 67, 67, 67, 67
+};
+
+static const uint8_t                            mcurses_width_blocks[202][WIDTH_BLOCK / 4] PROGMEM =
+{
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x5A,0x55 },
+    { 0xAA,0x55,0x95,0x59,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x15,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x95,0x56,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x10,0x41,0x10,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x6A,0x55,0xA9,0xAA,0xAA },
+    { 0x00,0x50,0x55,0x55,0x00,0x00,0x40,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x00,0x00,0x00,0x55,0x55,0x55,0x55,0x54,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x10,0x00,0x14,0x04,0x50,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x25,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0xA4,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x55,0x95,0x52 },
+    { 0x55,0x55,0x55,0x55,0x55,0x05,0x10,0x00,0x00,0x01,0x01,0xA0,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x9A,0x55,0x55,0x95,0xAA,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x95,0xA0,0xAA,0x00,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x54,0x01,0x00,0x54,0x51,0x01,0x00,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x51,0x56,0x55,0x69,0x69,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x99,0x5A,0xA5,0x54,0x01,0x68,0x69,0x91,0xAA,0x6A,0xAA,0x65,0x05,0x5A,0x55,0x55,0x55,0x55,0x55,0x85 },
+    { 0x42,0x56,0x95,0x6A,0x69,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x59,0x96,0xA5,0x58,0x81,0x2A,0x28,0xA0,0xA2,0xAA,0x56,0x99,0xAA,0x5A,0x55,0x55,0x50,0x91,0xAA,0xAA },
+    { 0x42,0x56,0x55,0x65,0x65,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x59,0x56,0xA5,0x54,0x01,0x20,0x64,0xA1,0xA9,0xAA,0xAA,0xAA,0x05,0x5A,0x55,0x55,0xA5,0xAA,0x06,0x00 },
+    { 0x52,0x56,0x55,0x69,0x69,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x59,0x56,0xA5,0x14,0x01,0x68,0x69,0xA1,0xAA,0x42,0xAA,0x65,0x05,0x5A,0x55,0x55,0x55,0x55,0xAA,0xAA },
+    { 0x4A,0x56,0x95,0x5A,0x59,0xA5,0x96,0x59,0x6A,0xA9,0x95,0x5A,0x55,0x55,0xA5,0x5A,0x94,0x5A,0x59,0xA1,0xA9,0x6A,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55,0x55,0x95,0xAA },
+    { 0x54,0x54,0x55,0x59,0x59,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x55,0x55,0xA5,0x04,0x54,0x09,0x08,0xA0,0xAA,0x82,0x95,0xA6,0x05,0x5A,0x55,0x55,0xAA,0x6A,0x55,0x55 },
+    { 0x51,0x55,0x55,0x59,0x59,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x55,0x56,0xA5,0x14,0x55,0x49,0x59,0xA0,0xAA,0x96,0xAA,0x96,0x05,0x5A,0x55,0x55,0x96,0xAA,0xAA,0xAA },
+    { 0x50,0x55,0x55,0x59,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x54,0x01,0x58,0x59,0x51,0xAA,0x55,0x55,0x55,0x05,0x5A,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x52,0x56,0x55,0x55,0x55,0x95,0x5A,0x55,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0xA6,0x55,0x95,0x8A,0x6A,0x05,0x88,0x55,0x55,0xAA,0x5A,0x55,0x55,0x5A,0xA9,0xAA,0xAA },
+    { 0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x00,0x80,0x6A,0x55,0x15,0x00,0x40,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x96,0x59,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x66,0x55,0x55,0x51,0x00,0x00,0xA4,0x55,0x99,0x00,0xA0,0x55,0x55,0xA5,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x11,0x51,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x02,0x00,0x00,0x40 },
+    { 0x00,0x04,0x55,0x01,0x00,0x00,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x58,0x55,0x45,0x55,0x59,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x04,0x00,0x41,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x05,0x54,0x55,0x55,0x55,0x01,0x54,0x55,0x55 },
+    { 0x45,0x41,0x55,0x51,0x55,0x55,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0xAA,0xA6,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0xA5,0x55,0x95,0x59,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x59,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0xA5,0x55,0x95,0x59,0xA5,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x59,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x02,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0xA5 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA },
+    { 0x55,0x55,0x55,0x55,0x05,0xA4,0xAA,0x6A,0x55,0x55,0x55,0x55,0x05,0x95,0xAA,0xAA,0x55,0x55,0x55,0x55,0x05,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x59,0x09,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x10,0x00,0x50,0x55,0x45,0x01,0x00,0x00,0x55,0x55,0xA1,0x55,0x55,0xA5,0xAA,0x55,0x55,0xA5,0xAA },
+    { 0x55,0x55,0x15,0x00,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA },
+    { 0x55,0x41,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x91,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x40,0x15,0x54,0xAA,0x45,0x55,0x01,0xAA,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0xA9,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0x55,0x55,0x95,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x15,0x14,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x00,0x80,0x44,0x01,0x00,0x54,0x15,0x00,0x00,0x28 },
+    { 0x55,0x55,0xA5,0xAA,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0xA5,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x04,0x40,0x54,0x45,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x55,0x55,0x95 },
+    { 0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x10,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x45,0x50,0x11,0x50,0xAA,0xAA,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x05,0x6A,0x55,0x55,0x55,0xA5,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0xA9,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0xAA,0xAA,0x40,0x00,0x00,0x00,0x04,0x00,0x54,0x51,0x55,0x54,0x90,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0xA5,0x55,0x55,0x66,0x66,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x55,0x55,0x59,0x55,0x55,0x55,0x5A,0x55,0x56,0x55,0x55,0x55,0x55,0x5A,0x59,0x55,0x95 },
+    { 0x55,0x55,0x15,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x08,0x00,0x00,0xA5,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x95,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xA8,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0x55,0x55,0x69,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x56,0x96,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x69 },
+    { 0x55,0x55,0x55,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95 },
+    { 0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x59,0x55,0xA5,0x55,0x55,0x55,0x55,0x69,0x55,0x5A,0x55,0x65,0x55,0x56,0x55,0x55,0x55,0x55,0x65,0x55,0xA5,0x59,0x65,0x59 },
+    { 0x55,0x59,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x66,0x95,0x9A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x56,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x5A,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0xAA,0x56,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0xAA,0xA6,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x6A,0xA9,0xAA,0xAA,0x2A },
+    { 0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0x55,0x95,0x55,0x95,0x55,0x95,0x55,0x95,0x55,0x95,0x55,0x95,0x55,0x95,0x55,0x95,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x0A,0xA0,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x82,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x40,0x00,0x00,0x50 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x50,0x55,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x65,0x56,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55 },
+    { 0x45,0x45,0x15,0x55,0x55,0x55,0x55,0x55,0x55,0x41,0x55,0xA8,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA0,0xAA,0x5A,0x55,0x55,0xA5,0xAA,0x00,0x00,0x00,0x00,0x50,0x55,0x55,0x15 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x50,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x50,0xAA,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x05,0x50,0x50,0x55,0x55,0x55,0x65,0x55,0x55,0xA5,0x5A,0x55,0x51,0x55,0x55,0x55,0x55,0x55,0x95 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x40,0x41,0x81,0xAA,0xAA,0x15,0x55,0x55,0xA4,0x55,0x55,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x54 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x04,0x14,0x54,0x05,0x91,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x55,0x55,0x55,0x55,0x50,0x55,0x85,0xAA,0xAA },
+    { 0x56,0x95,0x56,0x95,0x56,0x95,0xAA,0xAA,0x55,0x95,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x51,0x54,0xA1,0x55,0x55,0xA5,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x95,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA },
+    { 0x55,0x95,0xAA,0xAA,0x6A,0x55,0xAA,0x46,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x99,0x65,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55 },
+    { 0x00,0x00,0x00,0x00,0xAA,0xAA,0xAA,0xAA,0x00,0x00,0x00,0x00,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x59,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x29 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x5A,0x55,0x5A,0x55,0x5A,0x55,0x5A,0xA9,0xAA,0xAA,0x55,0x95,0xAA,0xAA,0x02,0xA5 },
+    { 0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x95,0x65,0x55,0x55,0x55,0xA5,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA },
+    { 0x95,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x95,0x55,0x55,0x55,0xA9,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA1 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x80,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0x6A,0x55,0x55,0x95,0x55 },
+    { 0x55,0x55,0x95,0x55,0x95,0x65,0x55,0x55,0x65,0x55,0x55,0x55,0x65,0x55,0x65,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0xA5,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0xA9,0x69,0x55,0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x6A,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x95,0xA5,0x6A,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x6A,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x01,0x82,0xAA,0x00,0x55,0x56,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x80,0x2A,0x55,0x55,0xA9,0xAA,0x55,0x55,0xA9,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x81,0x6A,0x55,0x55,0x95,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0xA5,0xAA,0x56,0xA9,0xAA,0xAA,0x56,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x5A,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x25,0xA4,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x00,0x54,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55 },
+    { 0x05,0x50,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA },
+    { 0x51,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x00,0x40,0x55,0xA5,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x14,0xA4,0xAA,0x2A },
+    { 0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x40,0x41,0x51,0x85,0xAA,0xAA,0xA2,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0x55,0x55,0xA5,0xAA },
+    { 0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x01,0x00,0x58,0x55,0x55,0x55,0x55,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x95,0xAA,0xAA },
+    { 0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x00,0x40,0x55,0x55,0x01,0x14,0x55,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0x04,0x55,0x85,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x95,0x59,0x65,0x55,0x55,0x55,0x65,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x15,0x00,0x80,0xAA,0x55,0x55,0xA5,0xAA },
+    { 0x50,0x56,0x55,0x69,0x69,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x59,0x56,0x25,0x54,0x54,0x69,0x69,0xA5,0xA9,0x6A,0xAA,0x56,0x55,0x0A,0x00,0xA8,0x00,0xA8,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x00,0x05,0x44,0x55,0x55,0x55,0x55,0x55,0x46,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x44,0x15,0x04,0x55,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0xA0,0x55,0x10,0x54,0x55,0x55,0x55,0x55,0x55,0x55,0xA0,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x40,0x11,0x54,0xA9,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x51,0x00,0x10,0xA5,0xAA,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x02,0x05,0x10,0x00,0xAA,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x00,0x41,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0x6A },
+    { 0x55,0x95,0xA6,0x55,0x55,0x96,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0x29,0x44,0x15,0x95,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x0A,0x55,0x54,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x01,0x00,0x40,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x00,0x14,0x40,0x55,0x15,0xAA,0xAA,0x01,0x40,0x01,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x05,0x00,0x00,0x40,0x50,0x55,0x95,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA },
+    { 0x55,0x55,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x80,0x00,0x10,0x55,0xA5,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x0A,0x00,0x00,0x00,0x00,0x00,0x06,0x00,0x04,0x81,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x95,0x65,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x01,0x80,0x8A,0x20,0x00,0x10,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0x55,0x65,0x59,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x95,0x60,0x11,0xA9,0xAA,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x15,0x54,0xA9,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA9,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0x6A },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0xA9,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x00,0x00,0xA8,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0xA5,0x5A,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x00,0xA4,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0x55,0x55,0x55,0xA5,0xAA,0xAA,0x55,0x55,0x65,0x55,0x65,0x55,0x55,0x55,0x55,0x55,0xAA,0x56 },
+    { 0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x2A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0xAA,0x2A,0x40,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA8,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0x55,0x55,0x55,0xA9 },
+    { 0x55,0x55,0xA9,0xAA,0x55,0x55,0xA5,0x41,0x00,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xA0,0x00,0x00,0x00,0x00,0x00,0x80,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x15,0x50,0x55,0x15,0x00,0x00,0x00 },
+    { 0x40,0x01,0x00,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0x50,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x05,0xA4,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x59,0x9A,0x96,0x56,0x59,0x55,0x55,0x65,0x56,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x65,0x95,0x56,0x55,0x59,0x55,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x65,0x95,0x55,0x99,0x5A,0x55,0x59,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x5A,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x54,0x55,0x51,0x55,0x55 },
+    { 0x55,0x54,0x55,0xAA,0xAA,0xAA,0x2A,0x00,0x02,0x00,0x00,0x00,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x00,0x80,0x00,0x00,0x00,0x00,0x28,0x00,0x20,0x08,0x80,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0x00,0x40,0x55,0xA5,0x55,0x55,0xA5,0x5A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x85,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x55,0x55,0xA5,0x6A },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x95,0x55,0x96,0x55,0x55,0x55,0x95 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x69,0x55,0x55,0x00,0x80,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x00,0x40,0xAA,0x55,0x55,0xA5,0x5A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x96,0x69,0x56,0x55,0x95,0x55,0x66,0xAA,0x9A,0x6A,0x66,0x56,0x96,0x69,0x66,0x66,0x96,0x69,0x95,0x55,0x95,0x55,0x56,0x99 },
+    { 0x55,0x55,0x65,0x55,0x55,0x55,0x55,0xAA,0x56,0x56,0x65,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA5,0xAA,0xAA,0xAA },
+    { 0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x56,0x55,0x55,0x95,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x65,0xA9,0xAA,0x6A,0x55,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x56,0x55,0x55,0xA9,0xAA,0x9A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xA6 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0x95,0xAA,0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0x56,0x56,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xA6,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x96 },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x55,0x95,0x6A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0x55,0x55,0x65,0x55 },
+    { 0x55,0x55,0x55,0x55,0x55,0x69,0x55,0x55,0x55,0x56,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA },
+    { 0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x5A,0x55,0x56,0x6A,0xA9,0xAA,0xAA,0x55,0x55,0x95,0xAA,0x55,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA9,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0x55,0x55,0xA5,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55 },
+    { 0x55,0x55,0xAA,0xAA,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xA5,0xA5,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x6A,0xAA,0xAA,0x9A,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0xAA,0xAA,0xAA,0x55,0x55,0x55,0xA5,0xAA,0xAA,0xAA,0xAA },
+    { 0x55,0x55,0x55,0x55,0x95,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x55,0x95,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0xAA,0x55,0x55,0xA5,0xAA }
+};
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return width of a character in columns: 0, 1 or 2
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_wcwidth (uint32_t ch)
+{
+    uint8_t     block;
+
+    if (ch < 0x20000)
+    {
+        block = pgm_read_byte(&mcurses_width_index[ch / WIDTH_BLOCK]);
+        return (pgm_read_byte(&mcurses_width_blocks[block][(ch % WIDTH_BLOCK) / 4]) >> (2 * (ch % 4))) & 0x03;
+    }
+
+    if (ch < 0x40000)                                                           // planes 2 and 3: CJK ideographs
+    {
+        return 2;
+    }
+
+    if (ch >= 0xE0000 && ch < 0xE1000)                                          // tags and variation selectors
+    {
+        return 0;
+    }
+    return 1;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: decode the UTF-8 sequence at str with max. n bytes (no limit if n < 0), return number of bytes used
+ *
+ * A byte which doesn't start a valid sequence - continuation byte, truncated or overlong sequence, surrogate, beyond
+ * 0x10FFFF - is taken alone as ACS character (0x80-0x9F) or ISO-8859-1 character (0xA0-0xFF).
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_utf8_decode (const char * str, int16_t n, MCURSES_CHAR * chp)
+{
+    MCURSES_CHAR    cp;
+    uint8_t         ch = str[0];
+    uint8_t         len;
+    uint8_t         i;
+
+    *chp = ch;
+
+    if (ch < 0xC2)                                                              // ASCII, continuation or overlong 2 byte sequence
+    {
+        return 1;
+    }
+    else if (ch < 0xE0)
+    {
+        cp  = ch & 0x1F;
+        len = 2;
+    }
+    else if (ch < 0xF0)
+    {
+        cp  = ch & 0x0F;
+        len = 3;
+    }
+    else if (ch < 0xF5)
+    {
+        cp  = ch & 0x07;
+        len = 4;
+    }
+    else
+    {
+        return 1;
+    }
+
+    if (n >= 0 && n < len)
+    {
+        return 1;
+    }
+
+    for (i = 1; i < len; i++)
+    {
+        ch = str[i];
+
+        if ((ch & 0xC0) != 0x80)                                                // also stops at end of string
+        {
+            return 1;
+        }
+        cp = (cp << 6) | (ch & 0x3F);
+    }
+
+    if ((len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)))
+    {
+        return 1;
+    }
+
+    *chp = cp;
+    return len;
+}
+#else
+typedef uint8_t                                 MCURSES_CHAR;
+
+#define WIDTH(ch)                               1
+#define IS_RUN_CHAR(ch)                         ((uint8_t) (ch) >= 0x20 && (ch) != 0x7F)
+#endif
+
+#if MCURSES_UNICODE_ACS
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: Unicode code points of the ACS characters 0x80-0x9F (DEC special graphics 0x60-0x7F)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static const uint16_t                           mcurses_acs_unicode[32] PROGMEM =
+{
+    0x25C6, 0x2592, 0x2409, 0x240C, 0x240D, 0x240A, 0x00B0, 0x00B1,             // diamond, checker board, HT, FF, CR, LF, degree, plus/minus
+    0x2424, 0x240B, 0x2518, 0x2510, 0x250C, 0x2514, 0x253C, 0x23BA,             // NL, VT, corners lr, ur, ul, ll, crossing lines, scan line 1
+    0x23BB, 0x2500, 0x23BC, 0x23BD, 0x251C, 0x2524, 0x2534, 0x252C,             // scan line 3, 5, 7, 9, tees left, right, bottom, top
+    0x2502, 0x2264, 0x2265, 0x03C0, 0x2260, 0x00A3, 0x00B7, 0x0020              // vline, less/equal, greater/equal, pi, not equal, pound, bullet, blank
+};
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put a character, switch character set if necessary (raw)
+ *
+ * With MCURSES_UNICODE_ACS an ACS character is sent as its Unicode code point, the terminal never leaves the G0 set.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_putch (MCURSES_CHAR ch)
+{
+#if MCURSES_UTF8
+    char        buf[4];
+    uint8_t     len;
+    uint8_t     i;
+
+#if MCURSES_UNICODE_ACS
+    if (ch >= 0x80 && ch <= 0x9F)
+    {
+        ch = pgm_read_word (&mcurses_acs_unicode[ch - 0x80]);
+    }
+#endif
+
+    if (ch >= 0xA0)                                                             // UTF-8 sequence
+    {
+        (void) mycharset (' ');                                                 // in G0 set
+
+        if (ch < 0x800)
+        {
+            buf[0]  = 0xC0 | (ch >> 6);
+            len     = 2;
+        }
+        else if (ch < 0x10000)
+        {
+            buf[0]  = 0xE0 | (ch >> 12);
+            len     = 3;
+        }
+        else
+        {
+            buf[0]  = 0xF0 | (ch >> 18);
+            len     = 4;
+        }
+
+        for (i = len - 1; i > 0; i--)
+        {
+            buf[i]  = 0x80 | (ch & 0x3F);
+            ch >>= 6;
         }
+
+        mcurses_putn (buf, len, 0);
+        return;
     }
+#endif
+    mcurses_putc (mycharset (ch));
+}
 
+#if ! MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: switch terminal to insert or replace mode if necessary
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+myinsertmode (uint8_t insert)
+{
     if (insert)
     {
-        if (! insert_mode)
+        if (! mcurses_insert_mode)
         {
             mcurses_puts_P (SEQ_INSERT_MODE);
-            insert_mode = TRUE;
+            mcurses_insert_mode = TRUE;
         }
     }
     else
     {
-        if (insert_mode)
+        if (mcurses_insert_mode)
         {
             mcurses_puts_P (SEQ_REPLACE_MODE);
-            insert_mode = FALSE;
+            mcurses_insert_mode = FALSE;
         }
     }
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: set scrolling region (raw), top == bottom: reset. The region is only sent if it differs from the region of the
+ * terminal. Returns TRUE if sent - then the cursor of the terminal is at home position.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mysetscrreg (uint8_t top, uint8_t bottom)
+{
+    if (top == bottom)
+    {
+        top = 0;
+        bottom = LINES - 1;
+    }
+
+    if (top == mcurses_phys_top && bottom == mcurses_phys_bottom)               // terminal has this region already
+    {
+        return FALSE;
+    }
+
+    if (top == 0 && bottom == LINES - 1)
+    {
+        mcurses_puts_P (SEQ_RESET_SCRREG);                                      // reset scrolling region
+    }
+    else
+    {
+        mcurses_puts_P (SEQ_CSI);
+        mcurses_puti (top + 1);
+        mcurses_putc (';');
+        mcurses_puti (bottom + 1);
+        mcurses_putc ('r');
+    }
+
+    mcurses_phys_top = top;
+    mcurses_phys_bottom = bottom;
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * move cursor (raw)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mymove (uint8_t y, uint8_t x)
+{
+    mcurses_puts_P (SEQ_CSI);
+    mcurses_puti (y + 1);
+
+    if (x > 0)                                                                  // column 1 is default
+    {
+        mcurses_putc (';');
+        mcurses_puti (x + 1);
+    }
+    mcurses_putc ('H');
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put control sequence with one parameter (raw), e.g. "ESC [ 5 C", parameter 1 is default and is omitted
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mycsi (uint8_t n, uint8_t final)
+{
+    mcurses_puts_P (SEQ_CSI);
+
+    if (n != 1)
+    {
+        mcurses_puti (n);
+    }
+    mcurses_putc (final);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: number of decimal digits
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_numlen (uint8_t n)
+{
+    return (n >= 100) ? 3 : ((n >= 10) ? 2 : 1);
+}
+
+#define CSI_COST(n)                             (3 + ((n) != 1 ? mcurses_numlen (n) : 0))   // bytes of mycsi()
+
+#define RECT_OK                                 (mcurses_rect && (mcurses_termcaps & TERMCAP_RECT))   // use DECFRA, DECERA, DECCRA
+#define MARGINS_OK                              (mcurses_margins && (mcurses_termcaps & TERMCAP_MARGINS))   // use DECSLRM
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put rectangular area operation (raw): DECFRA (final 'x', fill with ch), DECERA (final 'z', erase) or DECCRA
+ * (final 'v', copy to dsty, dstx). Lines top..bottom, columns left..right, the cursor does not move.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+myrect (uint8_t final, uint8_t ch, uint8_t top, uint8_t left, uint8_t bottom, uint8_t right, uint8_t dsty, uint8_t dstx)
+{
+    mcurses_puts_P (SEQ_CSI);
+
+    if (final == 'x')
+    {
+        mcurses_puti (ch);
+        mcurses_putc (';');
+    }
+
+    mcurses_puti (top + 1);
+    mcurses_putc (';');
+    mcurses_puti (left + 1);
+    mcurses_putc (';');
+    mcurses_puti (bottom + 1);
+    mcurses_putc (';');
+    mcurses_puti (right + 1);
+
+    if (final == 'v')
+    {
+        mcurses_putc (';');                                                     // source page: default
+        mcurses_putc (';');
+        mcurses_puti (dsty + 1);
+        mcurses_putc (';');
+        mcurses_puti (dstx + 1);
+    }
+
+    mcurses_putc ('$');
+    mcurses_putc (final);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: scroll rectangle top..bottom, left..right n lines up (n > 0) or -n lines down (n < 0) with left/right margins
+ * (raw): DECSLRM and DECSTBM, then SU or SD. The rectangle needs 2 lines and 2 columns at least. Afterwards the margins
+ * are reset, the scrolling region remains set and the cursor of the terminal is at home position.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+myscrollrect (uint8_t top, uint8_t bottom, uint8_t left, uint8_t right, int16_t n)
+{
+    if (! mcurses_lrmm)                                                         // allow margins once, DECSLRM needs it
+    {
+        mcurses_puts_P (SEQ_MARGINS_ON);
+        mcurses_lrmm = TRUE;
+    }
+
+    mcurses_puts_P (SEQ_CSI);                                                   // DECSLRM: set left/right margins
+    mcurses_puti (left + 1);
+    mcurses_putc (';');
+    mcurses_puti (right + 1);
+    mcurses_putc ('s');
+
+    (void) mysetscrreg (top, bottom);
+    mycsi ((n > 0) ? n : -n, (n > 0) ? 'S' : 'T');                              // scroll up or down within margins
+    mcurses_puts_P (SEQ_RESET_MARGINS);                                         // other output needs full lines
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: append a string from flash to buffer at position len, return new length
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_strcat_P (char * buf, uint8_t len, const char * str)
+{
+    uint8_t ch;
+
+    while ((ch = pgm_read_byte(str)) != '\0')
+    {
+        buf[len++] = ch;
+        str++;
+    }
+    return len;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: append a number 0...255 to buffer at position len, return new length
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_strcat_i (char * buf, uint8_t len, uint8_t i)
+{
+    if (i >= 100)
+    {
+        buf[len++] = i / 100 + '0';
+        i %= 100;
+        buf[len++] = i / 10 + '0';
+    }
+    else if (i >= 10)
+    {
+        buf[len++] = i / 10 + '0';
+    }
+
+    buf[len++] = i % 10 + '0';
+    return len;
+}
+
+#define MAX_COLOR_SGR                           17                              // max. length of encoded color: ";38;2;255;255;255"
+#define MAX_SGR                                 (3 + 2 * MAX_COLOR_SGR + 11)    // max. length of SGR sequence: "\033[0", colors, ";7;4;5;1;2m"
+#define MAX_SGR_DELTA                           (MAX_SGR + 10)                  // max. length of SGR sequence changing attributes
+#define COLOR_VALID(c)                          (((c) >= COLOR_DEFAULT && (c) <= 255) || ((c) & 0xFF000000L) == COLOR_RGB(0, 0, 0))
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: color pair, see init_pair(). The colors are encoded once, SGR sequences get a copy.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    int32_t         fg;                                                         // foreground color: COLOR_xxx, 0...255 or COLOR_RGB()
+    int32_t         bg;                                                         // background color
+    uint8_t         fglen;                                                      // length of encoded foreground color
+    uint8_t         bglen;                                                      // length of encoded background color
+    char            fgsgr[MAX_COLOR_SGR];                                       // encoded foreground color, e.g. ";38;5;208"
+    char            bgsgr[MAX_COLOR_SGR];                                       // encoded background color, e.g. ";48;2;0;0;128"
+} MCURSES_PAIR;
 
-    mcurses_putc (ch);
-    mcurses_curx++;
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: rendition of attribute(s) with colors resolved, compared to send changes of attributes only
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    int32_t         fg;                                                         // foreground color, COLOR_DEFAULT: none
+    int32_t         bg;                                                         // background color, COLOR_DEFAULT: none
+    uint8_t         mode;                                                       // A_UNDERLINE, A_REVERSE etc.
+} MCURSES_RENDITION;
+
+#define A_MODES                                 (A_UNDERLINE | A_REVERSE | A_BLINK | A_BOLD | A_DIM)
+
+#if MCURSES_COLOR_PAIRS > 256
+#error MCURSES_COLOR_PAIRS must not exceed 256, COLOR_PAIR() holds the pair in bits 8-15
+#endif
+
+static MCURSES_PAIR                             mcurses_pairs[MCURSES_COLOR_PAIRS]; // color pairs, pair 0: default colors
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: encode color as foreground (base '3') or background (base '4') in buf (MAX_COLOR_SGR bytes), return its length
+ *
+ * Colors 0...7 become ";3x", 8...15 (bright) ";9x", 16...255 ";38;5;n" and COLOR_RGB() ";38;2;r;g;b", background colors
+ * likewise. COLOR_DEFAULT needs nothing after "\033[0".
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_color_sgr (char * buf, int32_t color, uint8_t base)
+{
+    uint8_t         len = 0;
+
+    if (color == COLOR_DEFAULT)
+    {
+        return 0;
+    }
+
+    buf[len++] = ';';
+
+    if (color < 8)
+    {
+        buf[len++] = base;
+        buf[len++] = color + '0';
+    }
+    else if (color < 16)
+    {
+        if (base == '4')
+        {
+            buf[len++] = '1';
+            buf[len++] = '0';
+        }
+        else
+        {
+            buf[len++] = '9';
+        }
+        buf[len++] = color - 8 + '0';
+    }
+    else
+    {
+        buf[len++] = base;
+        buf[len++] = '8';
+        buf[len++] = ';';
+
+        if (color < 256)
+        {
+            buf[len++] = '5';
+            buf[len++] = ';';
+            len = mcurses_strcat_i (buf, len, color);
+        }
+        else
+        {
+            buf[len++] = '2';
+            buf[len++] = ';';
+            len = mcurses_strcat_i (buf, len, color >> 16);
+            buf[len++] = ';';
+            len = mcurses_strcat_i (buf, len, color >> 8);
+            buf[len++] = ';';
+            len = mcurses_strcat_i (buf, len, color);
+        }
+    }
+    return len;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: resolve attribute(s): colors of color pair or of F_xxx and B_xxx
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_rendition (MCURSES_RENDITION * rp, uint16_t attr)
+{
+    uint8_t         idx = attr >> 8;
+
+    rp->mode = attr & A_MODES;
+
+    if (attr & A_COLORPAIR)
+    {
+        if (idx >= MCURSES_COLOR_PAIRS)
+        {
+            idx = 0;
+        }
+        rp->fg = mcurses_pairs[idx].fg;
+        rp->bg = mcurses_pairs[idx].bg;
+    }
+    else
+    {
+        rp->fg = ((idx & 0x0F) <= 8) ? (int32_t) (idx & 0x0F) - 1 : COLOR_DEFAULT;  // F_BLACK...F_WHITE: 0...7
+        rp->bg = ((idx >> 4) <= 8) ? (int32_t) (idx >> 4) - 1 : COLOR_DEFAULT;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: append encoded foreground or background color (bg = TRUE) of attribute(s) with rendition rp to buffer at
+ * position len, return new length. Colors of pairs are copied from the pair.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_strcat_color (char * buf, uint8_t len, uint16_t attr, const MCURSES_RENDITION * rp, uint8_t bg)
+{
+    MCURSES_PAIR *  pp;
+
+    if ((attr & A_COLORPAIR) && (attr >> 8) < MCURSES_COLOR_PAIRS)
+    {
+        pp = &mcurses_pairs[attr >> 8];
+
+        if (bg)
+        {
+            memcpy (buf + len, pp->bgsgr, pp->bglen);
+            return len + pp->bglen;
+        }
+        memcpy (buf + len, pp->fgsgr, pp->fglen);
+        return len + pp->fglen;
+    }
+
+    return len + mcurses_color_sgr (buf + len, bg ? rp->bg : rp->fg, bg ? '4' : '3');
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: append parameters of modes A_REVERSE etc. to buffer at position len, return new length
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_strcat_modes (char * buf, uint8_t len, uint8_t mode)
+{
+    if (mode & A_REVERSE)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_REVERSE);
+    }
+    if (mode & A_UNDERLINE)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_UNDERLINE);
+    }
+    if (mode & A_BLINK)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_BLINK);
+    }
+    if (mode & A_BOLD)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_BOLD);
+    }
+    if (mode & A_DIM)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_DIM);
+    }
+    return len;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: build SGR sequence of attribute(s) in buf (MAX_SGR bytes), which resets all others, and resolve them in rp.
+ * Returns length of sequence.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_sgr (char * buf, MCURSES_RENDITION * rp, uint16_t attr)
+{
+    uint8_t         len;
+
+    mcurses_rendition (rp, attr);
+
+    len = mcurses_strcat_P (buf, 0, SEQ_ATTRSET);
+    len = mcurses_strcat_color (buf, len, attr, rp, FALSE);
+    len = mcurses_strcat_color (buf, len, attr, rp, TRUE);
+    len = mcurses_strcat_modes (buf, len, rp->mode);
+    buf[len++] = 'm';
+    return len;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: build SGR sequence in buf (MAX_SGR_DELTA bytes), which changes the terminal from rendition from to attribute(s)
+ * attr with rendition rp. Unchanged colors and modes are not sent again. Returns its length: 0 if nothing changes, maxlen
+ * if the sequence would not be shorter than maxlen.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_sgr_delta (char * buf, const MCURSES_RENDITION * from, uint16_t attr, const MCURSES_RENDITION * rp, uint8_t maxlen)
+{
+    uint8_t         off = from->mode & ~rp->mode;
+    uint8_t         on  = rp->mode & ~from->mode;
+    uint8_t         len = 1;                                                    // parameters begin with ';' at buf[1]
+
+    if (off & (A_BOLD | A_DIM))                                                 // one parameter resets both
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_NORMAL);
+        on |= rp->mode & (A_BOLD | A_DIM);
+    }
+    if (off & A_UNDERLINE)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_NO_UNDERLINE);
+    }
+    if (off & A_BLINK)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_NO_BLINK);
+    }
+    if (off & A_REVERSE)
+    {
+        len = mcurses_strcat_P (buf, len, SEQ_ATTRSET_NO_REVERSE);
+    }
+
+    if (rp->fg != from->fg)
+    {
+        len = (rp->fg == COLOR_DEFAULT) ? mcurses_strcat_P (buf, len, SEQ_ATTRSET_FDEFAULT) : mcurses_strcat_color (buf, len, attr, rp, FALSE);
+    }
+    if (rp->bg != from->bg)
+    {
+        len = (rp->bg == COLOR_DEFAULT) ? mcurses_strcat_P (buf, len, SEQ_ATTRSET_BDEFAULT) : mcurses_strcat_color (buf, len, attr, rp, TRUE);
+    }
+
+    len = mcurses_strcat_modes (buf, len, on);
+
+    if (len == 1)
+    {
+        return 0;
+    }
+
+    buf[0]      = '\033';                                                       // first ';' becomes CSI
+    buf[1]      = '[';
+    buf[len++]  = 'm';
+    return (len < maxlen) ? len : maxlen;
+}
+
+#if ! MCURSES_VIRTUAL_SCREEN
+static MCURSES_RENDITION                        mcurses_rendition_sent;         // attributes of terminal
+static uint8_t                                  mcurses_rendition_known;        // flag: attributes of terminal are known
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: set attribute(s) (raw), send changes only if shorter
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+myattrset (uint16_t attr)
+{
+    char                sgr[MAX_SGR];
+    char                delta[MAX_SGR_DELTA];
+    MCURSES_RENDITION   r;
+    uint8_t             len;
+    uint8_t             n;
+
+    len = mcurses_sgr (sgr, &r, attr);
+
+    if (mcurses_rendition_known && (n = mcurses_sgr_delta (delta, &mcurses_rendition_sent, attr, &r, len)) < len)
+    {
+        mcurses_putn (delta, n, 0);
+    }
+    else
+    {
+        mcurses_putn (sgr, len, 0);
+    }
+
+    mcurses_rendition_sent  = r;
+    mcurses_rendition_known = TRUE;
+}
+#endif
+
+#if MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: virtual screen
+ *
+ * All output functions only change the virtual screen. refresh() compares it with the physical screen - the state of the
+ * terminal after all output sent so far - and sends the differences only. Line and character shifts (deleteln(), delch() etc.)
+ * are recorded as terminal operations and replayed by refresh(), so the terminal moves the cells instead of mcurses
+ * rewriting them.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#if MCURSES_UTF8
+typedef struct
+{
+    uint32_t        ch : 24;                                                    // character, 0x80-0x9F: G1 graphic character
+    uint32_t        attr : 8;                                                   // attributes: index into palette
+} MCURSES_CELL;
+
+#define CH_WIDE_RIGHT                           0xFFFFFF                        // cell holds right half of wide character left of it
+#else
+typedef struct
+{
+    uint8_t         ch;                                                         // character, 0x80-0x9F: G1 graphic character
+    uint8_t         attr;                                                       // attributes: index into palette
+} MCURSES_CELL;
+#endif
+
+#define OP_SCROLL_UP                            1                               // scroll region up: delete line(s) at top
+#define OP_SCROLL_DOWN                          2                               // scroll region down: insert line(s) at top
+#define OP_DELCH                                3                               // delete character(s)
+#define OP_INSCH                                4                               // insert blank character(s)
+#define OP_FILLRECT                             5                               // fill rectangle with character (DECFRA)
+#define OP_ERASERECT                            6                               // erase rectangle (DECERA)
+#define OP_COPYRECT                             7                               // copy rectangle (DECCRA)
+#define OP_SCROLL_RECT_UP                       8                               // scroll rectangle up (DECSLRM + SU)
+#define OP_SCROLL_RECT_DOWN                     9                               // scroll rectangle down (DECSLRM + SD)
+
+#define MAX_OPS                                 16                              // max. number of recorded operations per frame
+#define OPS_OVERFLOW                            0xFF                            // too many operations, stop recording
+
+typedef struct
+{
+    uint8_t         op;                                                         // OP_xxx
+    uint8_t         y;                                                          // top line of region or line
+    uint8_t         x;                                                          // bottom line of region or column
+    uint8_t         n;                                                          // count or fill character of rectangle
+    uint8_t         attr;                                                       // attribute of new blank or filled cells
+    uint8_t         bottom;                                                     // rectangle: lines y..bottom,
+    uint8_t         right;                                                      // columns x..right, count in n
+    uint8_t         dsty;                                                       // destination of copied rectangle
+    uint8_t         dstx;
+} MCURSES_OP;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: palette of attributes
+ *
+ * Cells store an index into the palette, which holds each distinct attribute value on screen once, together with its SGR
+ * sequence. Sending attributes to the terminal is a copy of that sequence.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint16_t        attr;                                                       // attribute(s), see attrset()
+    uint8_t         bg;                                                         // palette index of background color alone
+    uint8_t         len;                                                        // length of SGR sequence, 0: entry is free
+    MCURSES_RENDITION r;                                                        // attribute(s) resolved, to send changes only
+    char            sgr[MAX_SGR];                                               // SGR sequence
+} MCURSES_PALETTE_ENTRY;
+
+#define ATTR_BG(a)                              (((a) & A_COLORPAIR) ? ((a) & (0xFF00 | A_COLORPAIR)) : ((a) & B_COLOR))
+#define ATTR_UNKNOWN                            0xFF                            // attribute of terminal or cell unknown
+#define POS_UNKNOWN                             0xFF                            // cursor position of terminal unknown
+
+static MCURSES_CELL                             mcurses_screen[LINES][COLS];    // virtual screen
+static MCURSES_CELL                             mcurses_phys[LINES][COLS];      // physical screen, state of terminal
+static uint8_t                                  mcurses_first[LINES];           // first changed column of line
+static uint8_t                                  mcurses_last[LINES];            // last changed column of line
+static MCURSES_OP                               mcurses_ops[MAX_OPS];           // recorded terminal operations
+static uint8_t                                  mcurses_nops;                   // number of recorded operations
+static MCURSES_PALETTE_ENTRY                    mcurses_palette[MCURSES_PALETTE];   // distinct attributes, entry 0: A_NORMAL
+static uint8_t                                  mcurses_palette_last;           // palette index found last
+static uint8_t                                  mcurses_attr;                   // current attributes: palette index, see attrset()
+static uint8_t                                  mcurses_clear_pending;          // flag: clear() called since last frame
+static uint8_t                                  mcurses_clear_attr;             // attribute of cleared screen
+static uint8_t                                  mcurses_cursor_vis = 1;         // cursor visibility, see curs_set()
+static uint8_t                                  mcurses_phys_y = POS_UNKNOWN;   // cursor position of terminal
+static uint8_t                                  mcurses_phys_x = POS_UNKNOWN;
+static uint8_t                                  mcurses_phys_attr = ATTR_UNKNOWN;   // attributes of terminal
+static uint8_t                                  mcurses_phys_cursor_vis = 1;    // cursor visibility of terminal
+static MCURSES_CELL                             mcurses_phys_save[LINES][COLS]; // copy of physical screen while counting
+#if MCURSES_UTF8
+static uint8_t                                  mcurses_wide;                   // flag: wide characters on screen since clear()
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: mark cells x1..x2 of line y as changed
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_touch (uint8_t y, uint8_t x1, uint8_t x2)
+{
+    if (x1 < mcurses_first[y])
+    {
+        mcurses_first[y] = x1;
+    }
+    if (x2 > mcurses_last[y])
+    {
+        mcurses_last[y] = x2;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: free palette entries not in use, keep entry keep. Returns a free entry or ATTR_UNKNOWN if all are in use.
+ *
+ * An entry is in use if a cell of the virtual or physical screen, a recorded operation, the current attributes, the
+ * attributes of the terminal or the background color of another entry in use refers to it.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_palette_free (uint8_t keep)
+{
+    uint8_t         used[MCURSES_PALETTE];
+    uint8_t         idx;
+    uint8_t         y;
+    uint8_t         x;
+
+    for (idx = 1; idx < MCURSES_PALETTE; idx++)
+    {
+        if (mcurses_palette[idx].len == 0)
+        {
+            return idx;
+        }
+    }
+
+    memset (used, FALSE, MCURSES_PALETTE);
+    used[0]                     = TRUE;                                         // A_NORMAL
+    used[mcurses_attr]          = TRUE;
+    used[mcurses_clear_attr]    = TRUE;
+
+    if (keep != ATTR_UNKNOWN)
+    {
+        used[keep] = TRUE;
+    }
+
+    if (mcurses_phys_attr != ATTR_UNKNOWN)
+    {
+        used[mcurses_phys_attr] = TRUE;
+    }
+
+    for (idx = 0; idx < mcurses_nops && idx < MAX_OPS; idx++)
+    {
+        used[mcurses_ops[idx].attr] = TRUE;
+    }
+
+    for (y = 0; y < LINES; y++)
+    {
+        for (x = 0; x < COLS; x++)
+        {
+            used[mcurses_screen[y][x].attr] = TRUE;
+
+            if (mcurses_phys[y][x].attr != ATTR_UNKNOWN)
+            {
+                used[mcurses_phys[y][x].attr] = TRUE;
+            }
+        }
+    }
+
+    for (idx = 0; idx < MCURSES_PALETTE; idx++)
+    {
+        if (used[idx])
+        {
+            used[mcurses_palette[idx].bg] = TRUE;                               // background of background is itself
+        }
+    }
+
+    x = ATTR_UNKNOWN;
+
+    for (idx = MCURSES_PALETTE - 1; idx > 0; idx--)
+    {
+        if (! used[idx])
+        {
+            mcurses_palette[idx].len = 0;
+            x = idx;
+        }
+    }
+    return x;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: return palette index of attribute(s), add a new entry with precomputed SGR sequence if necessary. If all
+ * entries are in use, the attributes fall back to A_NORMAL.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_intern (uint16_t attr)
+{
+    MCURSES_PALETTE_ENTRY * pe;
+    uint8_t                 bg;
+    uint8_t                 idx;
+
+    pe = &mcurses_palette[mcurses_palette_last];
+
+    if (pe->attr == attr && pe->len > 0)                                        // same as last time, e.g. run of cells
+    {
+        return mcurses_palette_last;
+    }
+
+    for (idx = 0; idx < MCURSES_PALETTE; idx++)
+    {
+        pe = &mcurses_palette[idx];
+
+        if (pe->attr == attr && pe->len > 0)
+        {
+            mcurses_palette_last = idx;
+            return idx;
+        }
+    }
+
+    bg = (ATTR_BG (attr) == attr) ? ATTR_UNKNOWN : mcurses_intern (ATTR_BG (attr));
+    idx = mcurses_palette_free (bg);
+
+    if (idx == ATTR_UNKNOWN)
+    {
+        return 0;
+    }
+
+    pe          = &mcurses_palette[idx];
+    pe->attr    = attr;
+    pe->bg      = (bg == ATTR_UNKNOWN) ? idx : bg;
+    pe->len     = mcurses_sgr (pe->sgr, &pe->r, attr);
+    mcurses_palette_last = idx;
+    return idx;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: colors of pair have changed: compute the SGR sequences of its palette entries again. Cells of the physical screen
+ * with these entries get attribute ATTR_UNKNOWN, so refresh() sends them again with the new colors. The cells are marked
+ * as changed where the virtual screen has them: recorded operations may still move cells of the physical screen there.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_recolor (uint8_t pair)
+{
+    uint8_t                 changed[MCURSES_PALETTE];
+    uint8_t                 any = FALSE;
+    MCURSES_PALETTE_ENTRY * pe;
+    uint8_t                 idx;
+    uint8_t                 y;
+    uint8_t                 x;
+
+    for (idx = 0; idx < MCURSES_PALETTE; idx++)
+    {
+        pe = &mcurses_palette[idx];
+        changed[idx] = (pe->len > 0 && (pe->attr & A_COLORPAIR) && (pe->attr >> 8) == pair);
+
+        if (changed[idx])
+        {
+            pe->len = mcurses_sgr (pe->sgr, &pe->r, pe->attr);
+            any = TRUE;
+        }
+    }
+
+    if (! any)
+    {
+        return;
+    }
+
+    if (mcurses_phys_attr != ATTR_UNKNOWN && changed[mcurses_phys_attr])
+    {
+        mcurses_phys_attr = ATTR_UNKNOWN;
+    }
+
+    for (y = 0; y < LINES; y++)
+    {
+        for (x = 0; x < COLS; x++)
+        {
+            if (mcurses_phys[y][x].attr != ATTR_UNKNOWN && changed[mcurses_phys[y][x].attr])
+            {
+                mcurses_phys[y][x].attr = ATTR_UNKNOWN;
+            }
+
+            if (changed[mcurses_screen[y][x].attr])
+            {
+                mcurses_touch (y, x, x);
+            }
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: fill cells x1..x2 of a line with character ch and attributes attr
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_fill (MCURSES_CELL * line, uint8_t x1, uint8_t x2, uint8_t ch, uint8_t attr)
+{
+    MCURSES_CELL *  cp;
+
+    for (cp = line + x1; cp <= line + x2; cp++)
+    {
+        cp->ch      = ch;
+        cp->attr    = attr;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: fill cells x1..x2 of a line with blanks, like the terminal erases: with current background color
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_blank (MCURSES_CELL * line, uint8_t x1, uint8_t x2, uint8_t attr)
+{
+    mcurses_fill (line, x1, x2, ' ', attr);
+}
+
+#if MCURSES_UTF8
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: blank halves of wide characters in line y of virtual screen, which lost the other half, e.g. by delch(),
+ * insch(), copyrect() or overwriting
+ *
+ * Recorded operations split the wide characters of the physical screen at the same places, so the terminal erases the
+ * same halves. The blanks are touched and sent, the neighbours too, because a wide character may start there.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_fixwide (MCURSES_CELL * line, uint8_t y)
+{
+    uint8_t     x;
+    uint8_t     ok;
+
+    for (x = 0; x < COLS; x++)
+    {
+        if (line[x].ch == CH_WIDE_RIGHT)
+        {
+            ok = (x > 0 && line[x - 1].ch != CH_WIDE_RIGHT && WIDTH (line[x - 1].ch) == 2);
+        }
+        else if (line[x].ch >= 0x1100 && WIDTH (line[x].ch) == 2)              // no wide characters below 0x1100
+        {
+            ok = (x < COLS - 1 && line[x + 1].ch == CH_WIDE_RIGHT);
+        }
+        else
+        {
+            continue;
+        }
+
+        if (! ok)
+        {
+            line[x].ch = ' ';
+            mcurses_touch (y, (x > 0) ? x - 1 : 0, (x < COLS - 1) ? x + 1 : x);
+        }
+    }
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: copy rectangle top..bottom, left..right of a screen to dsty, dstx, source and destination may overlap
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_copy_cells (MCURSES_CELL screen[][COLS], uint8_t top, uint8_t left, uint8_t bottom, uint8_t right, uint8_t dsty, uint8_t dstx)
+{
+    uint8_t     h = bottom - top;
+    uint8_t     i;
+    uint8_t     k;
+
+    for (i = 0; i <= h; i++)
+    {
+        k = (dsty <= top) ? i : h - i;                                          // don't overwrite lines not yet copied
+        memmove (&screen[dsty + k][dstx], &screen[top + k][left], (right - left + 1) * sizeof (MCURSES_CELL));
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: shift rectangle top..bottom, left..right of a screen n lines up (OP_SCROLL_RECT_UP) or down, n < lines
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_shift_rect (MCURSES_CELL screen[][COLS], uint8_t op, uint8_t top, uint8_t bottom, uint8_t left, uint8_t right, uint8_t n, uint8_t attr)
+{
+    uint8_t     y;
+
+    if (op == OP_SCROLL_RECT_UP)
+    {
+        mcurses_copy_cells (screen, top + n, left, bottom, right, top, left);
+        y = bottom - n + 1;
+    }
+    else
+    {
+        mcurses_copy_cells (screen, top, left, bottom - n, right, top + n, left);
+        y = top;
+    }
+
+    while (n--)
+    {
+        mcurses_blank (screen[y++], left, right, attr);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: rectangle top..bottom, left..right is copied to dsty, dstx: mark changes in it, which are not yet sent, in the
+ * destination. The terminal copies the old contents, refresh() sends the changes afterwards.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_copy_marks (uint8_t top, uint8_t left, uint8_t bottom, uint8_t right, uint8_t dsty, uint8_t dstx)
+{
+    uint8_t     h = bottom - top;
+    uint8_t     i;
+    uint8_t     k;
+    uint8_t     y;
+
+    for (i = 0; i <= h; i++)
+    {
+        k = (dsty <= top) ? i : h - i;                                          // same order as the cells: read marks first
+        y = top + k;
+
+        if (mcurses_first[y] <= right && mcurses_last[y] >= left)
+        {
+            mcurses_touch (dsty + k, dstx + ((mcurses_first[y] > left) ? mcurses_first[y] - left : 0),
+                           dstx + ((mcurses_last[y] < right) ? mcurses_last[y] : right) - left);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: shift lines top..bottom of a screen n lines up (OP_SCROLL_UP) or down (OP_SCROLL_DOWN)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_shift_lines (MCURSES_CELL screen[][COLS], uint8_t op, uint8_t top, uint8_t bottom, uint8_t n, uint8_t attr)
+{
+    uint8_t     lines = bottom - top + 1;
+    uint8_t     y;
+
+    if (n > lines)
+    {
+        n = lines;
+    }
+
+    if (op == OP_SCROLL_UP)
+    {
+        memmove (screen[top], screen[top + n], (lines - n) * sizeof (screen[0]));
+
+        for (y = bottom - n + 1; y <= bottom; y++)
+        {
+            mcurses_blank (screen[y], 0, COLS - 1, attr);
+        }
+    }
+    else
+    {
+        memmove (screen[top + n], screen[top], (lines - n) * sizeof (screen[0]));
+
+        for (y = top; y < top + n; y++)
+        {
+            mcurses_blank (screen[y], 0, COLS - 1, attr);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: shift characters x..COLS-1 of a line n characters left (OP_DELCH) or right (OP_INSCH)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_shift_chars (MCURSES_CELL * line, uint8_t op, uint8_t x, uint8_t n, uint8_t attr)
+{
+    if (n > COLS - x)
+    {
+        n = COLS - x;
+    }
+
+    if (op == OP_DELCH)
+    {
+        memmove (line + x, line + x + n, (COLS - x - n) * sizeof (MCURSES_CELL));
+        mcurses_blank (line, COLS - n, COLS - 1, attr);
+    }
+    else
+    {
+        memmove (line + x + n, line + x, (COLS - x - n) * sizeof (MCURSES_CELL));
+        mcurses_blank (line, x, x + n - 1, attr);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: allocate a terminal operation. Returns NULL if there are too many, then recording stops until the next frame.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static MCURSES_OP *
+mcurses_new_op (void)
+{
+    if (mcurses_nops == OPS_OVERFLOW)
+    {
+        return (MCURSES_OP *) 0;
+    }
+
+    if (mcurses_nops == MAX_OPS)
+    {
+        mcurses_nops = OPS_OVERFLOW;
+        return (MCURSES_OP *) 0;
+    }
+
+    return &mcurses_ops[mcurses_nops++];
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: record terminal operation, merge it with the previous one if possible. Returns FALSE if not recorded.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_add_op (uint8_t op, uint8_t y, uint8_t x, uint8_t n, uint8_t attr)
+{
+    MCURSES_OP *    p;
+
+    if (mcurses_nops > 0 && mcurses_nops != OPS_OVERFLOW)
+    {
+        p = &mcurses_ops[mcurses_nops - 1];
+
+        if (p->op == op && p->y == y && p->x == x && p->attr == attr && p->n <= 255 - n)
+        {
+            p->n += n;
+            return TRUE;
+        }
+    }
+
+    p = mcurses_new_op ();
+
+    if (! p)
+    {
+        return FALSE;
+    }
+
+    p->op   = op;
+    p->y    = y;
+    p->x    = x;
+    p->n    = n;
+    p->attr = attr;
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: scroll lines top..bottom of virtual screen n lines up (OP_SCROLL_UP) or down (OP_SCROLL_DOWN)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_scroll_region (uint8_t op, uint8_t top, uint8_t bottom, uint8_t n)
+{
+    uint8_t     attr = mcurses_palette[mcurses_attr].bg;
+    uint8_t     lines = bottom - top + 1;
+    uint8_t     y;
+
+    if (n >= lines)                                                             // whole region scrolled out: clear it
+    {
+        for (y = top; y <= bottom; y++)
+        {
+            mcurses_blank (mcurses_screen[y], 0, COLS - 1, attr);
+            mcurses_touch (y, 0, COLS - 1);
+        }
+        return;
+    }
+
+    mcurses_shift_lines (mcurses_screen, op, top, bottom, n, attr);
+
+    if (op == OP_SCROLL_UP)                                                     // change marks move with the lines
+    {
+        memmove (mcurses_first + top, mcurses_first + top + n, lines - n);
+        memmove (mcurses_last + top, mcurses_last + top + n, lines - n);
+        y = bottom - n + 1;
+    }
+    else
+    {
+        memmove (mcurses_first + top + n, mcurses_first + top, lines - n);
+        memmove (mcurses_last + top + n, mcurses_last + top, lines - n);
+        y = top;
+    }
+
+    memset (mcurses_first + y, 0, n);                                           // new lines: compare all columns
+    memset (mcurses_last + y, COLS - 1, n);
+
+    if (! mcurses_add_op (op, top, bottom, n, attr))                            // terminal won't shift: compare all lines
+    {
+        for (y = top; y <= bottom; y++)
+        {
+            mcurses_touch (y, 0, COLS - 1);
+        }
+    }
+}
+
+#define MAX_REWRITE                             8                               // max. cells to rewrite instead of moving
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: check if cells x1..x2-1 of physical line y can be sent again to move the cursor forward without side effects
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_rewritable (uint8_t y, uint8_t x1, uint8_t x2)
+{
+    MCURSES_CELL *  cp;
+#if ! MCURSES_UNICODE_ACS
+    uint8_t         g1 = (mcurses_charset == CHARSET_G1);
+#endif
+
+    if (x2 - x1 > MAX_REWRITE || x2 >= COLS || mcurses_phys_attr == ATTR_UNKNOWN)
+    {
+        return FALSE;
+    }
+
+    for (cp = &mcurses_phys[y][x1]; cp < &mcurses_phys[y][x2]; cp++)
+    {
+#if MCURSES_UNICODE_ACS
+        if (cp->attr != mcurses_phys_attr || cp->ch >= 0x80)                    // ACS and UTF-8: more bytes than cells
+        {
+            return FALSE;
+        }
+#else
+        if (cp->attr != mcurses_phys_attr || (cp->ch >= 0x80 && cp->ch <= 0x9F) != g1)
+        {
+            return FALSE;
+        }
+#if MCURSES_UTF8
+        if (cp->ch >= 0xA0)                                                     // UTF-8: more bytes than cells
+        {
+            return FALSE;
+        }
+#endif
+#endif
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: bytes needed to move the cursor on a line from column x1 to column x2
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_hcost (uint8_t y, uint8_t x1, uint8_t x2)
+{
+    uint8_t     cost;
+
+    if (x2 == x1)
+    {
+        return 0;
+    }
+
+    if (x2 > x1)
+    {
+        if (mcurses_rewritable (y, x1, x2))                                     // rewrite the cells
+        {
+            return x2 - x1;
+        }
+        return CSI_COST (x2 - x1);                                              // CUF
+    }
+
+    cost = CSI_COST (x1 - x2);                                                  // CUB
+
+    if (x1 - x2 < cost)                                                         // backspaces
+    {
+        cost = x1 - x2;
+    }
+    return cost;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: move cursor of terminal on a line from column x1 to column x2
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_hmove (uint8_t y, uint8_t x1, uint8_t x2)
+{
+    MCURSES_CELL *  cp;
+
+    if (x2 > x1)
+    {
+        if (mcurses_rewritable (y, x1, x2))
+        {
+            for (cp = &mcurses_phys[y][x1]; cp < &mcurses_phys[y][x2]; cp++)
+            {
+                mcurses_putc (mycharset (cp->ch));
+            }
+        }
+        else
+        {
+            mycsi (x2 - x1, 'C');
+        }
+    }
+    else if (x2 < x1)
+    {
+        if (x1 - x2 <= CSI_COST (x1 - x2))
+        {
+            while (x1-- > x2)
+            {
+                mcurses_putc ('\b');
+            }
+        }
+        else
+        {
+            mycsi (x1 - x2, 'D');
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: move cursor of terminal with the cheapest sequence
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#define MOVE_CUP                                0                               // absolute: ESC [ y ; x H
+#define MOVE_REL                                1                               // CUU/CUD, then along the line
+#define MOVE_CR                                 2                               // CR and LFs, then along the line
+
+static void
+mcurses_goto (uint8_t y, uint8_t x)
+{
+    uint8_t     py = mcurses_phys_y;
+    uint8_t     px = mcurses_phys_x;
+    uint8_t     best;
+    uint8_t     how = MOVE_CUP;
+    uint8_t     cross;
+    uint8_t     cost;
+
+    if (py == y && px == x)
+    {
+        return;
+    }
+
+    if (py != POS_UNKNOWN && px != POS_UNKNOWN)
+    {
+        best = 3 + mcurses_numlen (y + 1) + (x > 0 ? 1 + mcurses_numlen (x + 1) : 0);
+
+        cross = (y != py) &&                                                    // CUU/CUD stop at the margins and LF
+                (mcurses_phys_bottom == 0xff ||                                 // scrolls at bottom margin: don't cross
+                 (py <= mcurses_phys_bottom && mcurses_phys_bottom < y) ||      // a margin of the scrolling region
+                 (y < mcurses_phys_top && mcurses_phys_top <= py));
+
+        cost = (y == py) ? 0 : CSI_COST (y > py ? y - py : py - y);
+        cost += mcurses_hcost (y, px, x);
+
+        if (cost < best && ! cross)
+        {
+            best = cost;
+            how = MOVE_REL;
+        }
+
+        if (y >= py && ! cross)
+        {
+            cost = 1 + (y - py) + mcurses_hcost (y, 0, x);
+
+            if (cost < best)
+            {
+                how = MOVE_CR;
+            }
+        }
+    }
+
+    switch (how)
+    {
+        case MOVE_REL:
+            if (y > py)
+            {
+                mycsi (y - py, 'B');
+            }
+            else if (y < py)
+            {
+                mycsi (py - y, 'A');
+            }
+            mcurses_hmove (y, px, x);
+            break;
+        case MOVE_CR:
+            mcurses_putc ('\r');
+
+            while (py++ < y)
+            {
+                mcurses_putc ('\n');
+            }
+            mcurses_hmove (y, 0, x);
+            break;
+        default:
+            mymove (y, x);
+            break;
+    }
+
+    mcurses_phys_y = y;
+    mcurses_phys_x = x;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: set attributes of terminal if necessary. If known, only the changes are sent, when that is shorter.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_phys_attrset (uint8_t attr)
+{
+    MCURSES_PALETTE_ENTRY * pe = &mcurses_palette[attr];
+    char                    delta[MAX_SGR_DELTA];
+    uint8_t                 len = pe->len;
+
+    if (mcurses_phys_attr != attr)
+    {
+        if (mcurses_phys_attr != ATTR_UNKNOWN)
+        {
+            len = mcurses_sgr_delta (delta, &mcurses_palette[mcurses_phys_attr].r, pe->attr, &pe->r, pe->len);
+        }
+
+        mcurses_putn ((len < pe->len) ? delta : pe->sgr, len, 0);
+        mcurses_phys_attr = attr;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: replay recorded terminal operations and apply them to physical screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_replay_ops (void)
+{
+    MCURSES_OP *    p;
+    uint8_t         i;
+    uint8_t         n;
+
+    for (i = 0; i < mcurses_nops && i < MAX_OPS; i++)
+    {
+        p = &mcurses_ops[i];
+
+        if (p->op != OP_COPYRECT)                                               // new cells get the background color
+        {                                                                       // or the attributes of fill
+            mcurses_phys_attrset (p->attr);
+        }
+
+        if (p->op == OP_SCROLL_UP || p->op == OP_SCROLL_DOWN)
+        {
+            if (mysetscrreg (p->y, p->x))                                       // set scrolling region if changed,
+            {                                                                   // cursor goes home
+                mcurses_phys_y = 0;
+                mcurses_phys_x = 0;
+            }
+
+            if (p->op == OP_SCROLL_UP && mcurses_phys_y == p->x && 1 + p->n < CSI_COST (p->n))
+            {                                                                   // cursor on bottom margin: CR, LFs scroll
+                mcurses_putc ('\r');                                            // column 0, with or without ONLCR
+
+                for (n = 0; n < p->n; n++)
+                {
+                    mcurses_putc ('\n');
+                }
+                mcurses_phys_x = 0;
+            }
+            else
+            {
+                mycsi (p->n, (p->op == OP_SCROLL_UP) ? 'S' : 'T');              // scroll region up or down
+            }
+            mcurses_shift_lines (mcurses_phys, p->op, p->y, p->x, p->n, p->attr);
+        }
+        else if (p->op == OP_FILLRECT || p->op == OP_ERASERECT)
+        {
+            if (p->op == OP_FILLRECT)
+            {
+                myrect ('x', mycharset (p->n), p->y, p->x, p->bottom, p->right, 0, 0);
+            }
+            else
+            {
+                myrect ('z', 0, p->y, p->x, p->bottom, p->right, 0, 0);
+            }
+
+            for (n = p->y; n <= p->bottom; n++)
+            {
+                mcurses_fill (mcurses_phys[n], p->x, p->right, p->n, p->attr);
+            }
+        }
+        else if (p->op == OP_COPYRECT)
+        {
+            myrect ('v', 0, p->y, p->x, p->bottom, p->right, p->dsty, p->dstx);
+            mcurses_copy_cells (mcurses_phys, p->y, p->x, p->bottom, p->right, p->dsty, p->dstx);
+        }
+        else if (p->op == OP_SCROLL_RECT_UP || p->op == OP_SCROLL_RECT_DOWN)
+        {
+            myscrollrect (p->y, p->bottom, p->x, p->right, (p->op == OP_SCROLL_RECT_UP) ? p->n : -p->n);
+            mcurses_phys_y = 0;                                                 // cursor goes home
+            mcurses_phys_x = 0;
+            mcurses_shift_rect (mcurses_phys, p->op, p->y, p->bottom, p->x, p->right, p->n, p->attr);
+        }
+        else
+        {
+            mcurses_goto (p->y, p->x);
+            mycsi (p->n, (p->op == OP_DELCH) ? 'P' : '@');                      // delete or insert characters
+            mcurses_shift_chars (mcurses_phys[p->y], p->op, p->x, p->n, p->attr);
+        }
+    }
+
+    mcurses_nops = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: predicted time in microseconds to send a number of bytes with the estimated throughput of the link
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_wire_usecs (uint32_t bytes)
+{
+    return ((uint64_t) bytes * 1000000) / SHARED_LOAD (mcurses_throughput);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: send a cell, the cursor of the terminal must be at the cell position
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_putcell (MCURSES_CELL * cp)
+{
+    mcurses_phys_attrset (cp->attr);
+    mcurses_putch (cp->ch);
+
+    if (++mcurses_phys_x >= COLS)                                               // terminal waits for autowrap,
+    {                                                                           // position is not reliable anymore
+        mcurses_phys_x = POS_UNKNOWN;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: send the changed cells of a line
+ *
+ * STRATEGY_DELTA sends the changed cells only and moves the cursor over unchanged ones, STRATEGY_LINE sends all cells
+ * between the first and the last changed cell with one cursor movement.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_update_line (uint8_t y, uint8_t strategy)
+{
+    MCURSES_CELL *  vp = mcurses_screen[y];
+    MCURSES_CELL *  pp = mcurses_phys[y];
+    MCURSES_CELL *  tail = &vp[COLS - 1];
+    uint8_t         last = mcurses_last[y];
+    uint8_t         eol = COLS;
+    uint8_t         run = FALSE;
+    uint8_t         x;
+    uint8_t         n;
+    uint8_t         k;
+
+    if (tail->ch == ' ' && mcurses_palette[tail->attr].bg == tail->attr)        // line ends with erasable blanks?
+    {                                                                           // yes, is clear to end of line worth it?
+        for (x = COLS - 1; x > mcurses_first[y] && vp[x - 1].ch == ' ' && vp[x - 1].attr == tail->attr; x--)
+        {
+            ;
+        }
+
+        for (n = 0, eol = x; x <= last; x++)
+        {
+            if (vp[x].ch != pp[x].ch || vp[x].attr != pp[x].attr)
+            {
+                n++;
+            }
+        }
+
+        if (n <= 3 || (mcurses_phys_attr != tail->attr && n <= 10))             // no
+        {
+            eol = COLS;
+        }
+    }
+
+    if (strategy == STRATEGY_LINE && eol > 0)                                   // find last changed cell
+    {
+        if (last >= eol)
+        {
+            last = eol - 1;
+        }
+
+        while (last > mcurses_first[y] && vp[last].ch == pp[last].ch && vp[last].attr == pp[last].attr)
+        {
+            last--;
+        }
+    }
+
+    for (x = mcurses_first[y]; x <= last && x < eol; x++)
+    {
+#if MCURSES_UTF8
+        if (vp[x].ch == CH_WIDE_RIGHT)                                          // sent with left half
+        {
+            continue;
+        }
+#endif
+        if (run || vp[x].ch != pp[x].ch || vp[x].attr != pp[x].attr)
+        {
+            mcurses_goto (y, x);
+            mcurses_putcell (vp + x);
+            pp[x] = vp[x];
+            run = (strategy == STRATEGY_LINE);
+#if MCURSES_UTF8
+            if (x < COLS - 1 && vp[x + 1].ch == CH_WIDE_RIGHT)                  // wide character: right half is sent too
+            {
+                x++;
+                pp[x] = vp[x];
+                mcurses_phys_x = (x + 1 < COLS) ? x + 1 : POS_UNKNOWN;          // terminal waits for autowrap
+            }
+#endif
+
+            if (mcurses_rep)                                                    // repeat equal cells behind with REP?
+            {
+                for (n = 0, k = x + 1; k <= last && k < eol && vp[k].ch == vp[x].ch && vp[k].attr == vp[x].attr; k++)
+                {
+                    if (run || vp[k].ch != pp[k].ch || vp[k].attr != pp[k].attr)
+                    {
+                        n++;                                                    // cells which must be sent anyway
+                    }
+                }
+
+                k -= x + 1;
+
+                if (k > 0 && CSI_COST (k) < n)
+                {
+                    mycsi (k, 'b');
+
+                    while (k--)
+                    {
+                        x++;
+                        pp[x] = vp[x];
+                    }
+
+                    mcurses_phys_x = (x + 1 < COLS) ? x + 1 : POS_UNKNOWN;      // terminal waits for autowrap
+                }
+            }
+        }
+    }
+
+    if (eol < COLS)
+    {
+        mcurses_goto (y, eol);
+        mcurses_phys_attrset (tail->attr);
+        mcurses_puts_P (SEQ_CLRTOEOL);
+        mcurses_blank (pp, eol, COLS - 1, tail->attr);
+    }
+
+    mcurses_first[y]    = COLS;
+    mcurses_last[y]     = 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: send differences between virtual and physical screen with given strategy
+ *
+ * STRATEGY_FULL clears the terminal and sends the whole virtual screen, recorded operations are dropped.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_encode (uint8_t strategy)
+{
+    uint8_t     y;
+
+    if (strategy == STRATEGY_FULL)
+    {
+        mcurses_clear_pending   = TRUE;
+        mcurses_clear_attr      = mcurses_palette[mcurses_screen[LINES - 1][COLS - 1].attr].bg;
+        mcurses_nops            = 0;
+
+        for (y = 0; y < LINES; y++)
+        {
+            mcurses_first[y]    = 0;
+            mcurses_last[y]     = COLS - 1;
+        }
+    }
+
+    if (mcurses_clear_pending)
+    {
+        mcurses_phys_attrset (mcurses_clear_attr);                              // terminal clears with background color
+        mcurses_puts_P (SEQ_CLEAR);
+
+        for (y = 0; y < LINES; y++)
+        {
+            mcurses_blank (mcurses_phys[y], 0, COLS - 1, mcurses_clear_attr);
+        }
+        mcurses_clear_pending = FALSE;
+    }
+
+    if (mcurses_nops > 0)
+    {
+        mcurses_replay_ops ();
+    }
+
+    for (y = 0; y < LINES; y++)
+    {
+        if (mcurses_first[y] <= mcurses_last[y])
+        {
+            mcurses_update_line (y, strategy);
+        }
+    }
+
+    mcurses_goto (mcurses_cury, (mcurses_curx < COLS) ? mcurses_curx : COLS - 1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: return number of bytes mcurses_encode() would send with given strategy, state of terminal is not changed
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint32_t
+mcurses_encode_cost (uint8_t strategy)
+{
+    uint8_t     first[LINES];
+    uint8_t     last[LINES];
+    uint8_t     nops            = mcurses_nops;
+    uint8_t     clear_pending   = mcurses_clear_pending;
+    uint8_t     clear_attr      = mcurses_clear_attr;
+    uint8_t     phys_y          = mcurses_phys_y;
+    uint8_t     phys_x          = mcurses_phys_x;
+    uint8_t     phys_attr       = mcurses_phys_attr;
+#if ! MCURSES_UNICODE_ACS
+    uint8_t     charset         = mcurses_charset;
+#endif
+    uint8_t     phys_top        = mcurses_phys_top;
+    uint8_t     phys_bottom     = mcurses_phys_bottom;
+    uint8_t     lrmm            = mcurses_lrmm;
+
+    memcpy (first, mcurses_first, LINES);
+    memcpy (last, mcurses_last, LINES);
+    memcpy (mcurses_phys_save, mcurses_phys, sizeof (mcurses_phys));
+
+    mcurses_dry_bytes = 0;
+    mcurses_dry = TRUE;                                                         // count only, don't send
+    mcurses_encode (strategy);
+    mcurses_dry = FALSE;
+
+    memcpy (mcurses_phys, mcurses_phys_save, sizeof (mcurses_phys));
+    memcpy (mcurses_first, first, LINES);
+    memcpy (mcurses_last, last, LINES);
+    mcurses_nops            = nops;
+    mcurses_clear_pending   = clear_pending;
+    mcurses_clear_attr      = clear_attr;
+    mcurses_phys_y          = phys_y;
+    mcurses_phys_x          = phys_x;
+    mcurses_phys_attr       = phys_attr;
+#if ! MCURSES_UNICODE_ACS
+    mcurses_charset         = charset;
+#endif
+    mcurses_phys_top        = phys_top;
+    mcurses_phys_bottom     = phys_bottom;
+    mcurses_lrmm            = lrmm;
+
+    return mcurses_dry_bytes;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * SCREEN: send differences between virtual and physical screen, choose strategy with shortest time on the wire
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_update (void)
+{
+    uint32_t    usecs;
+    uint32_t    best_usecs  = 0xFFFFFFFF;
+    uint8_t     best        = STRATEGY_DELTA;
+    uint8_t     strategy;
+    uint8_t     y;
+
+    if (mcurses_cursor_vis == 0 && mcurses_phys_cursor_vis != 0)                // hide cursor before drawing
+    {
+        mcurses_puts_P (SEQ_CURSOR_VIS);
+        mcurses_putc ('l');
+        mcurses_phys_cursor_vis = 0;
+    }
+
+#if MCURSES_UTF8
+    if (mcurses_wide)                                                           // blank halves of wide characters
+    {
+        for (y = 0; y < LINES; y++)
+        {
+            mcurses_fixwide (mcurses_screen[y], y);
+        }
+    }
+#endif
+
+    for (y = 0; y < LINES && mcurses_first[y] > mcurses_last[y]; y++)          // anything changed?
+    {
+        ;
+    }
+
+    if (y < LINES || mcurses_nops > 0 || mcurses_clear_pending)                 // yes, predict time of each strategy
+    {
+        for (strategy = STRATEGY_DELTA; strategy <= STRATEGY_FULL; strategy++)
+        {
+            usecs = mcurses_wire_usecs (mcurses_encode_cost (strategy));
+
+            if (usecs < best_usecs)
+            {
+                best_usecs  = usecs;
+                best        = strategy;
+            }
+        }
+
+        mcurses_stats.strategy[best]++;
+        mcurses_stats.last_strategy = best;
+        mcurses_stats.last_usecs    = best_usecs;
+    }
+
+    mcurses_encode (best);
+
+    if (mcurses_cursor_vis != 0 && mcurses_phys_cursor_vis == 0)                // show cursor after drawing
+    {
+        mcurses_puts_P (SEQ_CURSOR_VIS);
+        mcurses_putc ('h');
+        mcurses_phys_cursor_vis = 1;
+    }
+}
+#endif // MCURSES_VIRTUAL_SCREEN
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: addch or insch a character
+ *
+ * A wide character takes two cells, in the last column it doesn't fit: the column is blanked and the character wraps.
+ * Combining and invisible characters (width 0) are dropped.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_addch_or_insch (MCURSES_CHAR ch, uint8_t insert)
+{
+    uint8_t w = WIDTH (ch);
+#if MCURSES_VIRTUAL_SCREEN
+    uint8_t y = mcurses_cury;
+    uint8_t x = mcurses_curx;
+
+    if (ch < 0x20 || ch == 0x7F)                                                // control character, others are ignored
+    {
+        switch (ch)
+        {
+            case '\n':                                                          // goto next line like LF with ONLCR
+                mcurses_curx = 0;
+
+                if (y == mcurses_scrl_end)
+                {
+                    scroll ();
+                }
+                else if (y < LINES - 1)
+                {
+                    mcurses_cury++;
+                }
+                break;
+            case '\r':
+                mcurses_curx = 0;
+                break;
+            case '\b':
+                if (x > 0)
+                {
+                    mcurses_curx--;
+                }
+                break;
+            case '\t':                                                          // next tab stop, cells stay like on terminal
+                mcurses_curx = (x < COLS - 8) ? (x | 7) + 1 : COLS - 1;
+                break;
+            case '\007':                                                        // bell: doesn't touch the screen, send now
+                mcurses_putc (ch);
+                break;
+        }
+        return;
+    }
+
+    if (w == 0)
+    {
+        return;
+    }
+
+    if (x >= COLS)                                                              // behind last column: wrap
+    {
+        if (y >= LINES - 1)
+        {
+            return;
+        }
+        mcurses_cury = ++y;
+        mcurses_curx = x = 0;
+    }
+
+    if (y >= LINES)
+    {
+        return;
+    }
+
+    if (x + w > COLS)                                                           // wide character in last column
+    {
+        mcurses_addch_or_insch (' ', insert);
+        mcurses_addch_or_insch (ch, insert);
+        return;
+    }
+
+    if (insert)
+    {
+        mcurses_shift_chars (mcurses_screen[y], OP_INSCH, x, w, mcurses_palette[mcurses_attr].bg);
+        mcurses_touch (y, x, COLS - 1);
+        (void) mcurses_add_op (OP_INSCH, y, x, w, mcurses_palette[mcurses_attr].bg);
+    }
+
+    mcurses_screen[y][x].ch     = ch;
+    mcurses_screen[y][x].attr   = mcurses_attr;
+#if MCURSES_UTF8
+    if (w == 2)
+    {
+        mcurses_screen[y][x + 1].ch     = CH_WIDE_RIGHT;
+        mcurses_screen[y][x + 1].attr   = mcurses_attr;
+        mcurses_wide = TRUE;
+    }
+#endif
+    mcurses_touch (y, x, x + w - 1);
+    mcurses_curx += w;
+#else
+    if (w == 0)
+    {
+        return;
+    }
+
+    if (w == 2 && mcurses_curx == COLS - 1)                                     // wide character in last column
+    {
+        mcurses_addch_or_insch (' ', insert);
+    }
+
+    if (ch == '\n' && (mcurses_phys_top != 0 || mcurses_phys_bottom != LINES - 1))
+    {                                                                           // LF must scroll the whole screen:
+        mcurses_puts_P (SEQ_SAVE_CURSOR);                                       // reset region left by scrl() or insdelln(),
+        (void) mysetscrreg (0, 0);                                              // DECSTBM homes the cursor
+        mcurses_puts_P (SEQ_RESTORE_CURSOR);
+    }
+
+    myinsertmode (insert);
+    mcurses_putch (ch);
+    mcurses_curx += w;
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add run of n printable characters, which fits into the current line
+ *
+ * Virtual screen: the cells are copied and the line is touched once. Terminal: insert mode is checked once and the
+ * characters go out in blocks of the same character set, so only a change between text and ACS (0x80-0x9F) switches
+ * between G0 and G1. With MCURSES_UNICODE_ACS an ACS block goes out as UTF-8 instead.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#define IS_ACS(ch)      ((uint8_t) (ch) >= 0x80 && (uint8_t) (ch) <= 0x9F)
+
+static void
+mcurses_addrun (const char * str, uint8_t n)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    MCURSES_CELL *  cp;
+    uint8_t         i;
+
+    if (mcurses_cury >= LINES)
+    {
+        return;
+    }
+
+    cp = &mcurses_screen[mcurses_cury][mcurses_curx];
+
+    for (i = 0; i < n; i++)
+    {
+        cp->ch      = (uint8_t) str[i];
+        cp->attr    = mcurses_attr;
+        cp++;
+    }
+
+    mcurses_touch (mcurses_cury, mcurses_curx, mcurses_curx + n - 1);
+    mcurses_curx += n;
+#else
+    uint8_t         len;
+    uint8_t         acs;
+
+    myinsertmode (FALSE);
+    mcurses_curx += n;
+
+    while (n)
+    {
+        acs = IS_ACS (*str);
+
+        for (len = 1; len < n && IS_ACS (str[len]) == acs; len++)
+        {
+            ;
+        }
+
+#if MCURSES_UNICODE_ACS
+        if (acs)
+        {
+            for (acs = 0; acs < len; acs++)
+            {
+                mcurses_putch ((uint8_t) str[acs]);
+            }
+        }
+        else
+        {
+            mcurses_putn (str, len, 0);
+        }
+#else
+        (void) mycharset (*str);                                                // switch G0/G1 once per block
+        mcurses_putn (str, len, acs ? 0x20 : 0);
+#endif
+        str += len;
+        n -= len;
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add up to n bytes of str, all bytes if n < 0
+ *
+ * Runs of printable characters up to the end of the line go to mcurses_addrun(), control characters and the wrap at
+ * the end of the line to mcurses_addch_or_insch(). With MCURSES_UTF8 a run holds ASCII and ACS characters only, the
+ * scan stops at the first byte >= 0xA0 and only then a UTF-8 sequence is decoded. So pure ASCII text costs no more.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_addnstr (const char * str, int16_t n)
+{
+#if MCURSES_UTF8
+    MCURSES_CHAR    wc;
+#endif
+    uint8_t         ch;
+    uint8_t         room;
+    uint8_t         len;
+
+    while (n != 0 && (ch = *str) != '\0')
+    {
+        if (! IS_RUN_CHAR (ch) || mcurses_curx >= COLS)
+        {
+#if MCURSES_UTF8
+            len = mcurses_utf8_decode (str, n, &wc);
+            mcurses_addch_or_insch (wc, FALSE);
+#else
+            mcurses_addch_or_insch (ch, FALSE);
+            len = 1;
+#endif
+        }
+        else
+        {
+            room = COLS - mcurses_curx;
+
+            for (len = 1; len < room && len != n; len++)
+            {
+                ch = str[len];
+
+                if (! IS_RUN_CHAR (ch))
+                {
+                    break;
+                }
+            }
+
+            mcurses_addrun (str, len);
+        }
+
+        str += len;
+
+        if (n > 0)
+        {
+            n -= len;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: initialize
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+initscr (void)
+{
+    uint16_t    pair;                                                           // MCURSES_COLOR_PAIRS may be 256
+
+    mcurses_phyio_init ();
+
+    for (pair = 0; pair < MCURSES_COLOR_PAIRS; pair++)                          // all pairs: default colors
+    {
+        mcurses_pairs[pair].fg      = COLOR_DEFAULT;
+        mcurses_pairs[pair].bg      = COLOR_DEFAULT;
+        mcurses_pairs[pair].fglen   = 0;
+        mcurses_pairs[pair].bglen   = 0;
+    }
+
+#if ! MCURSES_UNICODE_ACS
+    mcurses_charset = 0xff;                                                     // state of terminal is unknown
+#endif
+    mcurses_insert_mode = FALSE;
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_phys_y = POS_UNKNOWN;
+    mcurses_phys_x = POS_UNKNOWN;
+    mcurses_phys_attr = ATTR_UNKNOWN;
+    mcurses_phys_cursor_vis = 1;
+    mcurses_cursor_vis = 1;
+    memset (mcurses_palette, 0, sizeof (mcurses_palette));                      // palette holds A_NORMAL only
+    mcurses_palette[0].len = mcurses_sgr (mcurses_palette[0].sgr, &mcurses_palette[0].r, A_NORMAL);
+    mcurses_attr = 0;
+#else
+    mcurses_attr = A_NORMAL;
+    mcurses_rendition_known = FALSE;
+#endif
+#if ! MCURSES_UNICODE_ACS
+    mcurses_puts_P (SEQ_LOAD_G1);                                               // load graphic charset into G1
+#endif
+    mcurses_phys_top = 0xff;                                                    // scrolling region of terminal is unknown
+    (void) mysetscrreg (0, 0);                                                  // reset it
+    clear ();
+    move (0, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add character
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addch (uint8_t ch)
+{
+    mcurses_addch_or_insch (ch, FALSE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add string
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addstr (char * str)
+{
+    mcurses_addnstr (str, -1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add up to n characters of string, all if n < 0
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addnstr (const char * str, int16_t n)
+{
+    mcurses_addnstr (str, n);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: return number of bytes of the first n bytes of str (up to '\0' if n < 0) which fit into cols columns of the
+ * screen, store their width in *widthp if widthp is not NULL. A UTF-8 sequence is never cut, a wide character which
+ * doesn't fit is left out. Used to clip text by display width, e.g. before addnstr().
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+int16_t
+strfit (const char * str, int16_t n, uint8_t cols, uint8_t * widthp)
+{
+    int16_t         i       = 0;
+    uint8_t         width   = 0;
+#if MCURSES_UTF8
+    MCURSES_CHAR    ch;
+    uint8_t         len;
+    uint8_t         w;
+
+    while ((n < 0 || i < n) && str[i] != '\0')
+    {
+        len = mcurses_utf8_decode (str + i, (n < 0) ? -1 : n - i, &ch);
+        w   = WIDTH (ch);
+
+        if (width + w > cols)
+        {
+            break;
+        }
+
+        width   += w;
+        i       += len;
+    }
+#else
+    while ((n < 0 || i < n) && str[i] != '\0' && width < cols)
+    {
+        width++;
+        i++;
+    }
+#endif
+
+    if (widthp)
+    {
+        *widthp = width;
+    }
+    return i;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add string
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addstr_P (const char * str)
+{
+    char    buf[16 + 3];                                                        // block + rest of UTF-8 sequence
+    uint8_t len;
+
+    do
+    {
+        for (len = 0; len < 16 && (buf[len] = pgm_read_byte(str)) != '\0'; len++)   // copy block from flash
+        {
+            str++;
+        }
+#if MCURSES_UTF8
+        while (len >= 16 && len < sizeof (buf) && ((buf[len] = pgm_read_byte(str)) & 0xC0) == 0x80)    // don't split UTF-8 sequence
+        {
+            len++;
+            str++;
+        }
+#endif
+        mcurses_addnstr (buf, len);
+    } while (len >= 16);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add Unicode character
+ *
+ * Without MCURSES_UTF8 characters above 0xFF are shown as '?'. 0x80-0x9F are ACS characters in both cases.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+add_wch (uint32_t ch)
+{
+#if MCURSES_UTF8
+    mcurses_addch_or_insch (ch, FALSE);
+#else
+    mcurses_addch_or_insch ((ch <= 0xFF) ? ch : '?', FALSE);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add string of Unicode characters
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addwstr (const wchar_t * str)
+{
+    while (*str)
+    {
+        add_wch (*str++);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add n bytes of str to window, to stdscr if win == 0
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_fmt_put (WINDOW * win, const char * str, int16_t n)
+{
+    if (win)
+    {
+        waddnstr (win, str, n);
+    }
+    else
+    {
+        mcurses_addnstr (str, n);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add n times character ch to window, to stdscr if win == 0, the first size bytes of buf are used as block
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_fmt_pad (WINDOW * win, char * buf, uint8_t size, char ch, uint8_t n)
+{
+    uint8_t     len;
+
+    memset (buf, ch, (n < size) ? n : size);
+
+    while (n)
+    {
+        len = (n < size) ? n : size;
+        mcurses_fmt_put (win, buf, len);
+        n -= len;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: formatted output to window, to stdscr if win == 0, format string in flash if progmem is TRUE
+ *
+ * Conversions: %d %u %x %X %c %s %%, flag '-' (left-justify) or '0' (pad with zeros), a field width and 'l' for long
+ * arguments. Text between conversions and %s go to addnstr() in place, a number is built in a small buffer on the
+ * stack, so there is no stdio and no heap. The width of %s counts bytes.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_vprintw (WINDOW * win, const char * fmt, uint8_t progmem, va_list ap)
+{
+    char            buf[24];                                                    // number (long: up to 64 bit) or block of flash format
+    char *          p;
+    const char *    str;
+    long            sval;
+    unsigned long   val;
+    int16_t         len;
+    uint8_t         room;                                                       // free bytes in buf for padding
+    uint8_t         width;
+    uint8_t         left;
+    uint8_t         is_long;
+    uint8_t         base;
+    uint8_t         digit;
+    char            pad;
+    char            sign;
+    char            ch;
+
+    while (1)
+    {
+        if (progmem)                                                            // copy text from flash block by block
+        {
+            do
+            {
+                for (len = 0; len < 16 && (ch = pgm_read_byte(fmt)) != '\0' && ch != '%'; len++)
+                {
+                    buf[len] = ch;
+                    fmt++;
+                }
+#if MCURSES_UTF8
+                while (len >= 16 && len < (int16_t) sizeof (buf) && ((ch = pgm_read_byte(fmt)) & 0xC0) == 0x80)    // don't split UTF-8 sequence
+                {
+                    buf[len++] = ch;
+                    fmt++;
+                }
+#endif
+                mcurses_fmt_put (win, buf, len);
+            } while (len >= 16);
+
+            ch = pgm_read_byte(fmt);
+        }
+        else                                                                    // text in RAM: add it in place
+        {
+            for (len = 0; fmt[len] != '\0' && fmt[len] != '%'; len++)
+            {
+                ;
+            }
+
+            if (len > 0)
+            {
+                mcurses_fmt_put (win, fmt, len);
+                fmt += len;
+            }
+
+            ch = *fmt;
+        }
+
+        if (ch == '\0')
+        {
+            break;
+        }
+
+        fmt++;                                                                  // skip '%'
+        left    = FALSE;
+        pad     = ' ';
+        width   = 0;
+        is_long = FALSE;
+
+        while (1)                                                               // flags
+        {
+            ch = progmem ? pgm_read_byte(fmt) : *fmt;
+
+            if (ch == '-')
+            {
+                left = TRUE;
+            }
+            else if (ch == '0')
+            {
+                pad = '0';
+            }
+            else
+            {
+                break;
+            }
+            fmt++;
+        }
+
+        while (ch >= '0' && ch <= '9')                                          // field width
+        {
+            width = 10 * width + (ch - '0');
+            fmt++;
+            ch = progmem ? pgm_read_byte(fmt) : *fmt;
+        }
+
+        if (ch == 'l')
+        {
+            is_long = TRUE;
+            fmt++;
+            ch = progmem ? pgm_read_byte(fmt) : *fmt;
+        }
+
+        if (ch == '\0')                                                         // incomplete conversion at end of format
+        {
+            break;
+        }
+        fmt++;
+
+        if (left)
+        {
+            pad = ' ';                                                          // '-' overrides '0'
+        }
+
+        sign = 0;
+
+        if (ch == 'd' || ch == 'u' || ch == 'x' || ch == 'X')
+        {
+            if (ch == 'd')
+            {
+                sval = is_long ? va_arg (ap, long) : va_arg (ap, int);
+
+                if (sval < 0)
+                {
+                    sign = '-';
+                    val = - (unsigned long) sval;
+                }
+                else
+                {
+                    val = sval;
+                }
+            }
+            else
+            {
+                val = is_long ? va_arg (ap, unsigned long) : va_arg (ap, unsigned int);
+            }
+
+            base = (ch == 'x' || ch == 'X') ? 16 : 10;
+            p = buf + sizeof (buf);
+
+            do                                                                  // digits from the right
+            {
+                digit = val % base;
+                val /= base;
+                *--p = (digit < 10) ? digit + '0' : digit - 10 + ((ch == 'X') ? 'A' : 'a');
+            } while (val);
+
+            if (sign && pad == ' ')                                             // sign before the number
+            {
+                *--p = sign;
+                sign = 0;
+            }
+            str = p;
+            len = (buf + sizeof (buf)) - p;
+            room = p - buf;
+        }
+        else if (ch == 's')
+        {
+            str = va_arg (ap, const char *);
+            len = strlen (str);
+            room = sizeof (buf);
+        }
+        else                                                                    // %c, %% or unknown conversion: one character
+        {
+            p = buf + sizeof (buf) - 1;
+            *p = (ch == 'c') ? va_arg (ap, int) : ch;
+            str = p;
+            len = 1;
+            room = sizeof (buf) - 1;
+        }
+
+        if (sign)                                                               // sign before the zeros
+        {
+            mcurses_fmt_put (win, &sign, 1);
+
+            if (width > 0)
+            {
+                width--;
+            }
+        }
+
+        if (! left && width > len)
+        {
+            mcurses_fmt_pad (win, buf, room, pad, width - len);
+        }
+
+        mcurses_fmt_put (win, str, len);
+
+        if (left && width > len)
+        {
+            mcurses_fmt_pad (win, buf, sizeof (buf), ' ', width - len);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: formatted output, see mcurses_vprintw() for the conversions
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+printw (const char * fmt, ...)
+{
+    va_list     ap;
+
+    va_start (ap, fmt);
+    mcurses_vprintw ((WINDOW *) 0, fmt, FALSE, ap);
+    va_end (ap);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: formatted output, format string in flash (PROGMEM)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+printw_P (const char * fmt, ...)
+{
+    va_list     ap;
+
+    va_start (ap, fmt);
+    mcurses_vprintw ((WINDOW *) 0, fmt, TRUE, ap);
+    va_end (ap);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: copy up to n cells to the current line, up to the end of the line if n < 0. A cell with ch == 0 ends the row.
+ *
+ * Unlike addstr(), the cursor stays, nothing wraps and control characters are shown as blanks. Without virtual screen,
+ * an SGR sequence is only sent where the attribute changes between neighbouring cells, and the attribute set by
+ * attrset() is restored at the end.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+addchnstr (const chtype * cp, int16_t n)
+{
+    uint8_t         y = mcurses_cury;
+    uint8_t         x = mcurses_curx;
+    uint8_t         ch;
+    uint8_t         i;
+#if MCURSES_VIRTUAL_SCREEN
+    MCURSES_CELL *  vp;
+#else
+    uint16_t        attr = mcurses_attr;
+#endif
+
+    if (y >= LINES || x >= COLS)
+    {
+        return;
+    }
+
+    if (n < 0 || n > COLS - x)
+    {
+        n = COLS - x;
+    }
+
+#if MCURSES_VIRTUAL_SCREEN
+    vp = &mcurses_screen[y][x];
+
+    for (i = 0; i < n && (ch = cp[i].ch) != '\0'; i++)
+    {
+        vp[i].ch    = (ch < 0x20 || ch == 0x7F) ? ' ' : ch;
+        vp[i].attr  = mcurses_intern (cp[i].attr);
+    }
+
+    if (i > 0)
+    {
+        mcurses_touch (y, x, x + i - 1);
+    }
+#else
+    myinsertmode (FALSE);
+
+    for (i = 0; i < n && (ch = cp[i].ch) != '\0'; i++)
+    {
+        if (cp[i].attr != attr)                                                 // merge equal attributes of neighbours
+        {
+            attr = cp[i].attr;
+            myattrset (attr);
+        }
+
+        if (ch < 0x20 || ch == 0x7F)
+        {
+            ch = ' ';
+        }
+        mcurses_putch (ch);
+    }
+
+    if (attr != mcurses_attr)
+    {
+        myattrset (mcurses_attr);
+    }
+
+    if (i > 0)
+    {
+        mymove (y, x);                                                          // cursor stays
+    }
+#endif
+}
+
+#if MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: copy up to n cells from the current line of the virtual screen to cp, up to the end of the line if n < 0.
+ * The cursor stays. Returns the number of cells copied.
+ *
+ * A character beyond ISO-8859-1 is read as '?', the right half of a wide character as blank: chtype holds 8 bits only.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+int16_t
+inchnstr (chtype * cp, int16_t n)
+{
+    MCURSES_CELL *  vp;
+    int16_t         i;
+
+    if (mcurses_cury >= LINES || mcurses_curx >= COLS)
+    {
+        return 0;
+    }
+
+    if (n < 0 || n > COLS - mcurses_curx)
+    {
+        n = COLS - mcurses_curx;
+    }
+
+    vp = &mcurses_screen[mcurses_cury][mcurses_curx];
+
+    for (i = 0; i < n; i++)
+    {
+#if MCURSES_UTF8
+        if (vp[i].ch == CH_WIDE_RIGHT)
+        {
+            cp[i].ch = ' ';
+        }
+        else if (vp[i].ch > 0xFF)
+        {
+            cp[i].ch = '?';
+        }
+        else
+#endif
+        {
+            cp[i].ch = vp[i].ch;
+        }
+        cp[i].attr = mcurses_palette[vp[i].attr].attr;
+    }
+    return n;
+}
+#endif
+
+#if ! MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put character n times (n > 0), the repetitions with one REP sequence if enabled and cheaper (raw)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_putrep (uint8_t ch, uint8_t n)
+{
+    mcurses_putch (ch);
+    n--;
+
+    if (mcurses_rep && n > 0 && CSI_COST (n) < n)
+    {
+        mycsi (n, 'b');
+    }
+    else
+    {
+        while (n--)
+        {
+            mcurses_putch (ch);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: cursor is behind cell y, x just written, go to same column in next line (dir = 1) or previous line (dir = -1)
+ *
+ * BS and CUD/CUU cost 4 bytes instead of up to 9 for CUP. In the last column the terminal waits for autowrap and BS is
+ * not needed. CUD/CUU stop at the margins of the scrolling region, there CUP is used.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_vstep (uint8_t y, uint8_t x, int8_t dir)
+{
+    if (y == ((dir > 0) ? mcurses_phys_bottom : mcurses_phys_top))
+    {
+        mymove (y + dir, x);
+    }
+    else
+    {
+        if (x < COLS - 1)
+        {
+            mcurses_putc ('\b');
+        }
+        mycsi (1, (dir > 0) ? 'B' : 'A');
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: put character n times (n > 0) from cursor at y, x downwards (dir = 1) or upwards (dir = -1) (raw)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_vput (uint8_t y, uint8_t x, uint8_t ch, uint8_t n, int8_t dir)
+{
+    while (1)
+    {
+        mcurses_putch (ch);
+
+        if (--n == 0)
+        {
+            break;
+        }
+
+        mcurses_vstep (y, x, dir);
+        y += dir;
+    }
+}
+#endif
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw line of n cells (n > 0) with current attributes from y, x to the right or downwards, it must fit on screen
+ *
+ * Virtual screen: the cells are set, refresh() finds the cheapest cursor movements.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_line (uint8_t y, uint8_t x, uint8_t ch, uint8_t n, uint8_t vertical)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    MCURSES_CELL *  cp;
+
+    while (n--)
+    {
+        cp          = &mcurses_screen[y][x];
+        cp->ch      = ch;
+        cp->attr    = mcurses_attr;
+        mcurses_touch (y, x, x);
+
+        if (vertical)
+        {
+            y++;
+        }
+        else
+        {
+            x++;
+        }
+    }
+#else
+    mymove (y, x);
+    myinsertmode (FALSE);
+
+    if (vertical)
+    {
+        mcurses_vput (y, x, ch, n, 1);
+    }
+    else
+    {
+        mcurses_putrep (ch, n);
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: draw border of rectangle of h x w cells (h, w >= 2) at y, x with characters ls, rs, ts, bs, tl, tr, bl, br
+ *
+ * Without virtual screen the border is drawn in one pass: top line, left side downwards, bottom line, right side
+ * upwards. So only two CUP sequences are needed, the sides use BS and CUD/CUU.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_border (uint8_t y, uint8_t x, uint8_t h, uint8_t w, const uint8_t * c)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_line (y, x, c[4], 1, FALSE);
+    mcurses_line (y, x + w - 1, c[5], 1, FALSE);
+    mcurses_line (y + h - 1, x, c[6], 1, FALSE);
+    mcurses_line (y + h - 1, x + w - 1, c[7], 1, FALSE);
+
+    if (w > 2)
+    {
+        mcurses_line (y, x + 1, c[2], w - 2, FALSE);
+        mcurses_line (y + h - 1, x + 1, c[3], w - 2, FALSE);
+    }
+
+    if (h > 2)
+    {
+        mcurses_line (y + 1, x, c[0], h - 2, TRUE);
+        mcurses_line (y + 1, x + w - 1, c[1], h - 2, TRUE);
+    }
+#else
+    mymove (y, x);
+    myinsertmode (FALSE);
+    mcurses_putrep (c[4], 1);
+
+    if (w > 2)
+    {
+        mcurses_putrep (c[2], w - 2);
+    }
+    mcurses_putrep (c[5], 1);
+
+    if (h > 2)
+    {
+        mymove (y + 1, x);
+        mcurses_vput (y + 1, x, c[0], h - 2, 1);
+        mcurses_vstep (y + h - 2, x, 1);
+    }
+    else
+    {
+        mymove (y + 1, x);
+    }
+
+    mcurses_putrep (c[6], 1);
+
+    if (w > 2)
+    {
+        mcurses_putrep (c[3], w - 2);
+    }
+    mcurses_putrep (c[7], 1);
+
+    if (h > 2)
+    {
+        mcurses_vstep (y + h - 1, x + w - 1, -1);
+        mcurses_vput (y + h - 2, x + w - 1, c[1], h - 2, -1);
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: replace 0 by default characters of a border: ACS lines and corners
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_border_chars (uint8_t * c)
+{
+    static const uint8_t acs[8] = { ACS_VLINE, ACS_VLINE, ACS_HLINE, ACS_HLINE, ACS_ULCORNER, ACS_URCORNER, ACS_LLCORNER, ACS_LRCORNER };
+    uint8_t             i;
+
+    for (i = 0; i < 8; i++)
+    {
+        if (c[i] == 0)
+        {
+            c[i] = acs[i];
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw horizontal line of n characters ch from the cursor to the right, ch = 0: ACS_HLINE. The cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+hline (uint8_t ch, uint8_t n)
+{
+    if (mcurses_cury >= LINES || mcurses_curx >= COLS || n == 0)
+    {
+        return;
+    }
+
+    if (n > COLS - mcurses_curx)
+    {
+        n = COLS - mcurses_curx;
+    }
+
+    mcurses_line (mcurses_cury, mcurses_curx, ch ? ch : ACS_HLINE, n, FALSE);
+#if ! MCURSES_VIRTUAL_SCREEN
+    mymove (mcurses_cury, mcurses_curx);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw vertical line of n characters ch from the cursor downwards, ch = 0: ACS_VLINE. The cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+vline (uint8_t ch, uint8_t n)
+{
+    if (mcurses_cury >= LINES || mcurses_curx >= COLS || n == 0)
+    {
+        return;
+    }
+
+    if (n > LINES - mcurses_cury)
+    {
+        n = LINES - mcurses_cury;
+    }
+
+    mcurses_line (mcurses_cury, mcurses_curx, ch ? ch : ACS_VLINE, n, TRUE);
+#if ! MCURSES_VIRTUAL_SCREEN
+    mymove (mcurses_cury, mcurses_curx);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw border around the screen: left, right, top and bottom side, corners top left, top right, bottom left
+ * and bottom right. A character 0 draws the default ACS line or corner. The cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+border (uint8_t ls, uint8_t rs, uint8_t ts, uint8_t bs, uint8_t tl, uint8_t tr, uint8_t bl, uint8_t br)
+{
+    uint8_t     c[8];
+
+    c[0] = ls; c[1] = rs; c[2] = ts; c[3] = bs; c[4] = tl; c[5] = tr; c[6] = bl; c[7] = br;
+    mcurses_border_chars (c);
+    mcurses_border (0, 0, LINES, COLS, c);
+#if ! MCURSES_VIRTUAL_SCREEN
+    mymove (mcurses_cury, mcurses_curx);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: set attribute(s)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+attrset (uint16_t attr)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_attr = mcurses_intern (attr);
+#else
+    mcurses_attr = attr;
+    myattrset (attr);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: get attribute(s) set by attrset()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint16_t
+getattrs (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    return mcurses_palette[mcurses_attr].attr;
+#else
+    return mcurses_attr;
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: set colors of pair (1...MCURSES_COLOR_PAIRS - 1) to foreground fg and background bg: COLOR_xxx, 0...255 for
+ * the 256 color palette of the terminal or COLOR_RGB(). Returns OK or ERR.
+ *
+ * Attributes with COLOR_PAIR(pair) get these colors. With virtual screen, refresh() shows the new colors also in cells
+ * drawn before, without one only output from now on gets them.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+init_pair (uint8_t pair, int32_t fg, int32_t bg)
+{
+    MCURSES_PAIR *  pp;
+
+    if (pair == 0 || pair >= MCURSES_COLOR_PAIRS || ! COLOR_VALID (fg) || ! COLOR_VALID (bg))
+    {
+        return ERR;
+    }
+
+    pp          = &mcurses_pairs[pair];
+    pp->fg      = fg;
+    pp->bg      = bg;
+    pp->fglen   = mcurses_color_sgr (pp->fgsgr, fg, '3');
+    pp->bglen   = mcurses_color_sgr (pp->bgsgr, bg, '4');
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_recolor (pair);
+#endif
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: move cursor
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+move (uint8_t y, uint8_t x)
+{
+    mcurses_cury = y;
+    mcurses_curx = x;
+#if ! MCURSES_VIRTUAL_SCREEN
+    mymove (y, x);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: insert n lines (n > 0) or delete -n lines (n < 0) at current line position
+ *
+ * The lines from the current line to the end of the scrolling region are shifted. The terminal gets one counted sequence.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+insdelln (int8_t n)
+{
+#if ! MCURSES_VIRTUAL_SCREEN
+    uint8_t     top;
+#endif
+
+    if (n == 0 || mcurses_cury > mcurses_scrl_end || (n < 0 && mcurses_cury < mcurses_scrl_start))
+    {
+        return;
+    }
+
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_scroll_region ((n > 0) ? OP_SCROLL_DOWN : OP_SCROLL_UP, mcurses_cury, mcurses_scrl_end, (n > 0) ? n : -n);
+#else
+    top = (mcurses_cury >= mcurses_scrl_start) ? mcurses_scrl_start : mcurses_cury;
+
+    if (top == mcurses_scrl_end)                                                // region has one line: clear it
+    {
+        mymove (mcurses_cury, 0);
+        mcurses_puts_P (SEQ_CLRTOEOL);
+    }
+    else
+    {
+        mysetscrreg (top, mcurses_scrl_end);                                    // set scrolling region if changed
+        mymove (mcurses_cury, 0);                                               // goto to current line
+        mycsi ((n > 0) ? n : -n, (n > 0) ? 'L' : 'M');                          // insert or delete lines
+    }
+    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: delete line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+deleteln (void)
+{
+    insdelln (-1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: insert line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+insertln (void)
+{
+    insdelln (1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: scroll scrolling region n lines up (n > 0) or -n lines down (n < 0)
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+scrl (int16_t n)
+{
+    uint16_t    k = (n > 0) ? n : -n;
+
+    if (n == 0 || mcurses_scrl_start > mcurses_scrl_end)
+    {
+        return;
+    }
+
+    if (k > LINES)                                                              // region is cleared anyway
+    {
+        k = LINES;
+    }
+
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_scroll_region ((n > 0) ? OP_SCROLL_UP : OP_SCROLL_DOWN, mcurses_scrl_start, mcurses_scrl_end, k);
+#else
+    if (mcurses_scrl_start == mcurses_scrl_end)                                 // region has one line: clear it
+    {
+        mymove (mcurses_scrl_start, 0);
+        mcurses_puts_P (SEQ_CLRTOEOL);
+    }
+    else
+    {
+        (void) mysetscrreg (mcurses_scrl_start, mcurses_scrl_end);              // set scrolling region if changed
+        mycsi (k, (n > 0) ? 'S' : 'T');                                         // scroll up or down
+    }
+    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: scroll one line up
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+scroll (void)
+{
+    scrl (1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: clear
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+clear (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    uint8_t     y;
+
+    mcurses_clear_attr = mcurses_palette[mcurses_attr].bg;
+
+    for (y = 0; y < LINES; y++)
+    {
+        mcurses_blank (mcurses_screen[y], 0, COLS - 1, mcurses_clear_attr);
+        mcurses_first[y]    = COLS;                                             // terminal clears the screen,
+        mcurses_last[y]     = 0;                                                // nothing else to do
+    }
+    mcurses_nops = 0;
+    mcurses_clear_pending = TRUE;
+#if MCURSES_UTF8
+    mcurses_wide = FALSE;
+#endif
+#else
+    mcurses_puts_P (SEQ_CLEAR);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: clear to bottom of screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+clrtobot (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    uint8_t     y;
+
+    clrtoeol ();
+
+    for (y = mcurses_cury + 1; y < LINES; y++)
+    {
+        mcurses_blank (mcurses_screen[y], 0, COLS - 1, mcurses_palette[mcurses_attr].bg);
+        mcurses_touch (y, 0, COLS - 1);
+    }
+#else
+    mcurses_puts_P (SEQ_CLRTOBOT);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: clear to end of line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+clrtoeol (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    if (mcurses_curx < COLS && mcurses_cury < LINES)
+    {
+        mcurses_blank (mcurses_screen[mcurses_cury], mcurses_curx, COLS - 1, mcurses_palette[mcurses_attr].bg);
+        mcurses_touch (mcurses_cury, mcurses_curx, COLS - 1);
+    }
+#else
+    mcurses_puts_P (SEQ_CLRTOEOL);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: delete character at cursor position
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delch (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    if (mcurses_curx < COLS && mcurses_cury < LINES)
+    {
+        mcurses_shift_chars (mcurses_screen[mcurses_cury], OP_DELCH, mcurses_curx, 1, mcurses_palette[mcurses_attr].bg);
+        mcurses_touch (mcurses_cury, mcurses_curx, COLS - 1);
+        (void) mcurses_add_op (OP_DELCH, mcurses_cury, mcurses_curx, 1, mcurses_palette[mcurses_attr].bg);
+    }
+#else
+    mcurses_puts_P (SEQ_DELCH);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: insert character
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+insch (uint8_t ch)
+{
+    mcurses_addch_or_insch (ch, TRUE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: set scrolling region
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+setscrreg (uint8_t t, uint8_t b)
+{
+    mcurses_scrl_start = t;
+    mcurses_scrl_end = b;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: erase columns x1..x2 of line y with current background color, cursor position is not changed
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_erase (uint8_t y, uint8_t x1, uint8_t x2)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_blank (mcurses_screen[y], x1, x2, mcurses_palette[mcurses_attr].bg);
+    mcurses_touch (y, x1, x2);
+#else
+    mymove (y, x1);
+
+    if (x2 == COLS - 1)
+    {
+        mcurses_puts_P (SEQ_CLRTOEOL);                                          // EL: erase to end of line
+    }
+    else
+    {
+        mycsi (x2 - x1 + 1, 'X');                                               // ECH: erase characters
+    }
+    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: fill rectangle top..bottom, left..right with character ch (not a control character) and current attributes,
+ * erase = TRUE: with blanks and current background color. The rectangle must fit on screen, the cursor stays.
+ *
+ * If rectoutput() is on and the terminal has reported rectangular editing, it gets one DECFRA or DECERA sequence, with
+ * virtual screen recorded as terminal operation. Otherwise the lines are written: with virtual screen by refresh(),
+ * without one line by line with REP or EL/ECH.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_fillrect (uint8_t top, uint8_t left, uint8_t bottom, uint8_t right, uint8_t ch, uint8_t erase)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    uint8_t         attr = erase ? mcurses_palette[mcurses_attr].bg : mcurses_attr;
+    MCURSES_OP *    p = (MCURSES_OP *) 0;
+    uint8_t         y;
+
+    for (y = top; y <= bottom; y++)
+    {
+        mcurses_fill (mcurses_screen[y], left, right, ch, attr);
+    }
+
+    if (RECT_OK && ch < 0x7F)                                                   // DECFRA: no G1 graphic characters
+    {
+        p = mcurses_new_op ();
+    }
+
+    if (p)
+    {
+        p->op       = erase ? OP_ERASERECT : OP_FILLRECT;
+        p->y        = top;
+        p->x        = left;
+        p->bottom   = bottom;
+        p->right    = right;
+        p->n        = ch;
+        p->attr     = attr;
+    }
+    else                                                                        // terminal won't fill: compare the lines
+    {
+        for (y = top; y <= bottom; y++)
+        {
+            mcurses_touch (y, left, right);
+        }
+    }
+#else
+    uint8_t         y;
+
+    if (RECT_OK && ch < 0x7F)
+    {
+        if (erase)
+        {
+            myrect ('z', 0, top, left, bottom, right, 0, 0);
+        }
+        else
+        {
+            myrect ('x', mycharset (ch), top, left, bottom, right, 0, 0);
+        }
+        return;
+    }
+
+    myinsertmode (FALSE);
+
+    for (y = top; y <= bottom; y++)
+    {
+        mymove (y, left);
+
+        if (! erase)
+        {
+            mcurses_putrep (ch, right - left + 1);
+        }
+        else if (right == COLS - 1)
+        {
+            mcurses_puts_P (SEQ_CLRTOEOL);                                      // EL: erase to end of line
+        }
+        else
+        {
+            mycsi (right - left + 1, 'X');                                      // ECH: erase characters
+        }
+    }
+    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: copy rectangle top..bottom, left..right to dsty, dstx, both must fit on screen, they may overlap. The cursor
+ * stays. Returns FALSE if the terminal can't copy and there is no virtual screen.
+ *
+ * With virtual screen and DECCRA the copy is recorded as terminal operation, see mcurses_copy_marks().
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_copyrect (uint8_t top, uint8_t left, uint8_t bottom, uint8_t right, uint8_t dsty, uint8_t dstx)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    MCURSES_OP *    p = (MCURSES_OP *) 0;
+    uint8_t         h = bottom - top;
+    uint8_t         i;
+
+    if (RECT_OK)
+    {
+        p = mcurses_new_op ();
+    }
+
+    if (p)
+    {
+        p->op       = OP_COPYRECT;
+        p->y        = top;
+        p->x        = left;
+        p->bottom   = bottom;
+        p->right    = right;
+        p->dsty     = dsty;
+        p->dstx     = dstx;
+        mcurses_copy_marks (top, left, bottom, right, dsty, dstx);
+    }
+    else                                                                        // terminal won't copy: compare destination
+    {
+        for (i = 0; i <= h; i++)
+        {
+            mcurses_touch (dsty + i, dstx, dstx + right - left);
+        }
+    }
+
+    mcurses_copy_cells (mcurses_screen, top, left, bottom, right, dsty, dstx);
+    return TRUE;
+#else
+    if (RECT_OK)
+    {
+        myrect ('v', 0, top, left, bottom, right, dsty, dstx);
+        return TRUE;
+    }
+    return FALSE;
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: scroll rectangle n lines up (n > 0) or down (n < 0). Returns FALSE if the terminal can't scroll or copy it and
+ * there is no virtual screen.
+ *
+ * If marginoutput() is on and the terminal knows left/right margins, the terminal scrolls it like a scrolling region,
+ * see myscrollrect(). Otherwise the remaining lines are copied and the new ones erased, see copyrect().
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static uint8_t
+mcurses_scroll_rect (uint8_t top, uint8_t bottom, uint8_t left, uint8_t right, int16_t n)
+{
+    uint8_t         lines = bottom - top + 1;
+    uint16_t        k = (n > 0) ? n : -n;
+#if MCURSES_VIRTUAL_SCREEN
+    MCURSES_OP *    p;
+#endif
+
+    if (k > lines)                                                              // rectangle is erased anyway
+    {
+        k = lines;
+    }
+
+    if (MARGINS_OK && k < lines && left < right)                                // DECSTBM and DECSLRM need 2 lines, 2 columns
+    {
+#if MCURSES_VIRTUAL_SCREEN
+        p = mcurses_new_op ();
+
+        if (p)
+        {
+            p->op       = (n > 0) ? OP_SCROLL_RECT_UP : OP_SCROLL_RECT_DOWN;
+            p->y        = top;
+            p->x        = left;
+            p->bottom   = bottom;
+            p->right    = right;
+            p->n        = k;
+            p->attr     = mcurses_palette[mcurses_attr].bg;
+
+            if (n > 0)
+            {
+                mcurses_copy_marks (top + k, left, bottom, right, top, left);
+            }
+            else
+            {
+                mcurses_copy_marks (top, left, bottom - k, right, top + k, left);
+            }
+            mcurses_shift_rect (mcurses_screen, p->op, top, bottom, left, right, k, p->attr);
+            return TRUE;
+        }
+#else
+        myscrollrect (top, bottom, left, right, n);
+        mymove (mcurses_cury, mcurses_curx);                                    // restore position
+        return TRUE;
+#endif
+    }
+
+    if (k >= lines)                                                             // whole rectangle scrolled out: erase it
+    {
+        mcurses_fillrect (top, left, bottom, right, ' ', TRUE);
+    }
+    else if (n > 0)
+    {
+        if (! mcurses_copyrect (top + k, left, bottom, right, top, left))
+        {
+            return FALSE;
+        }
+        mcurses_fillrect (bottom - k + 1, left, bottom, right, ' ', TRUE);
+    }
+    else
+    {
+        if (! mcurses_copyrect (top, left, bottom - k, right, top + k, left))
+        {
+            return FALSE;
+        }
+        mcurses_fillrect (top, left, top + k - 1, right, ' ', TRUE);
+    }
+    return TRUE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: fill rectangle of nlines x ncols cells at line y, column x with character ch and current attributes. The
+ * rectangle ends at the edges of the screen, the cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+fillrect (uint8_t y, uint8_t x, uint8_t nlines, uint8_t ncols, uint8_t ch)
+{
+    if (y >= LINES || x >= COLS || nlines == 0 || ncols == 0)
+    {
+        return;
+    }
+
+    if (nlines > LINES - y)
+    {
+        nlines = LINES - y;
+    }
+
+    if (ncols > COLS - x)
+    {
+        ncols = COLS - x;
+    }
+
+    if (ch < 0x20 || ch == 0x7F)                                                // control character: show blank
+    {
+        ch = ' ';
+    }
+
+    mcurses_fillrect (y, x, y + nlines - 1, x + ncols - 1, ch, FALSE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: erase rectangle of nlines x ncols cells at line y, column x with current background color. The rectangle
+ * ends at the edges of the screen, the cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+eraserect (uint8_t y, uint8_t x, uint8_t nlines, uint8_t ncols)
+{
+    if (y >= LINES || x >= COLS || nlines == 0 || ncols == 0)
+    {
+        return;
+    }
+
+    if (nlines > LINES - y)
+    {
+        nlines = LINES - y;
+    }
+
+    if (ncols > COLS - x)
+    {
+        ncols = COLS - x;
+    }
+
+    mcurses_fillrect (y, x, y + nlines - 1, x + ncols - 1, ' ', TRUE);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: copy rectangle of nlines x ncols cells at line y, column x to line dsty, column dstx. Source and destination
+ * may overlap, both end at the edges of the screen, the cursor stays. Returns ERR if the terminal can't copy and there
+ * is no virtual screen.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+copyrect (uint8_t y, uint8_t x, uint8_t nlines, uint8_t ncols, uint8_t dsty, uint8_t dstx)
+{
+    if (y >= LINES || x >= COLS || dsty >= LINES || dstx >= COLS)
+    {
+        return ERR;
+    }
+
+    if (nlines > LINES - y)
+    {
+        nlines = LINES - y;
+    }
+
+    if (nlines > LINES - dsty)
+    {
+        nlines = LINES - dsty;
+    }
+
+    if (ncols > COLS - x)
+    {
+        ncols = COLS - x;
+    }
+
+    if (ncols > COLS - dstx)
+    {
+        ncols = COLS - dstx;
+    }
+
+    if (nlines == 0 || ncols == 0)
+    {
+        return OK;
+    }
+
+    return mcurses_copyrect (y, x, y + nlines - 1, x + ncols - 1, dsty, dstx) ? OK : ERR;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: create window, nlines or ncols = 0: window extends to bottom or right edge of screen
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+WINDOW *
+newwin (uint8_t nlines, uint8_t ncols, uint8_t begy, uint8_t begx)
+{
+    WINDOW *    win;
+
+    if (begy >= LINES || begx >= COLS)
+    {
+        return (WINDOW *) 0;
+    }
+
+    if (nlines == 0)
+    {
+        nlines = LINES - begy;
+    }
+
+    if (ncols == 0)
+    {
+        ncols = COLS - begx;
+    }
+
+    if (nlines > LINES - begy || ncols > COLS - begx)
+    {
+        return (WINDOW *) 0;
+    }
+
+    win = malloc (sizeof (WINDOW));
+
+    if (win)
+    {
+        win->begy       = begy;
+        win->begx       = begx;
+        win->maxy       = nlines;
+        win->maxx       = ncols;
+        win->cury       = 0;
+        win->curx       = 0;
+        win->scrl_start = 0;
+        win->scrl_end   = nlines - 1;
+        win->scroll     = FALSE;
+    }
+    return win;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: delete window, the contents on the screen remain
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+delwin (WINDOW * win)
+{
+    free (win);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: move cursor of window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+wmove (WINDOW * win, uint8_t y, uint8_t x)
+{
+    if (y >= win->maxy || x >= win->maxx)
+    {
+        return ERR;
+    }
+
+    win->cury = y;
+    win->curx = x;
+    move (win->begy + y, win->begx + x);
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: set scrolling region of window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+wsetscrreg (WINDOW * win, uint8_t t, uint8_t b)
+{
+    if (t > b || b >= win->maxy)
+    {
+        return ERR;
+    }
+
+    win->scrl_start = t;
+    win->scrl_end = b;
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: allow waddch() to scroll the window at the end of its scrolling region
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+scrollok (WINDOW * win, uint8_t flag)
+{
+    win->scroll = flag;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: scroll scrolling region of window n lines up (n > 0) or -n lines down (n < 0)
+ *
+ * Windows with the full width of the screen are scrolled by the terminal with one counted sequence. Narrower windows are
+ * scrolled by the terminal within left/right margins (see marginoutput()) or copied and erased as rectangles (see
+ * copyrect()). Without both they are redrawn by refresh() if the screen is virtual, otherwise they can't be scrolled.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+wscrl (WINDOW * win, int16_t n)
+{
+    uint8_t     scrl_start;
+    uint8_t     scrl_end;
+
+    if (win->begx == 0 && win->maxx == COLS)
+    {
+        scrl_start = mcurses_scrl_start;
+        scrl_end = mcurses_scrl_end;
+        mcurses_scrl_start = win->begy + win->scrl_start;
+        mcurses_scrl_end = win->begy + win->scrl_end;
+        scrl (n);
+        mcurses_scrl_start = scrl_start;
+        mcurses_scrl_end = scrl_end;
+        return OK;
+    }
+
+    if (n != 0 && ! mcurses_scroll_rect (win->begy + win->scrl_start, win->begy + win->scrl_end, win->begx, win->begx + win->maxx - 1, n))
+    {
+        return ERR;
+    }
+    return OK;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: clear window from cursor to end of line
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+wclrtoeol (WINDOW * win)
+{
+    mcurses_erase (win->begy + win->cury, win->begx + win->curx, win->begx + win->maxx - 1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: clear window, cursor goes home
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+werase (WINDOW * win)
+{
+    mcurses_fillrect (win->begy, win->begx, win->begy + win->maxy - 1, win->begx + win->maxx - 1, ' ', TRUE);
+    (void) wmove (win, 0, 0);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: goto next line of window, scroll if allowed
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_wnewline (WINDOW * win)
+{
+    win->curx = 0;
+
+    if (win->cury == win->scrl_end)
+    {
+        if (win->scroll)
+        {
+            (void) wscrl (win, 1);
+        }
+    }
+    else if (win->cury < win->maxy - 1)
+    {
+        win->cury++;
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: add character to window, lines wrap at the right edge of the window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_waddch (WINDOW * win, MCURSES_CHAR ch)
+{
+    uint8_t w;
+
+    switch (ch)
+    {
+        case '\n':                                                              // as addch(): next line, no clrtoeol
+            mcurses_wnewline (win);
+            break;
+        case '\r':
+            win->curx = 0;
+            break;
+        case '\b':
+            if (win->curx > 0)
+            {
+                win->curx--;
+            }
+            break;
+        default:
+            w = WIDTH (ch);
+
+            if (ch >= ' ' && w > 0 && w <= win->maxx)                           // ignore other control characters
+            {
+                if (win->curx + w > win->maxx)                                  // wide character at right edge of window
+                {
+                    mcurses_waddch (win, ' ');
+                }
+
+                if (mcurses_cury != win->begy + win->cury || mcurses_curx != win->begx + win->curx)
+                {
+                    move (win->begy + win->cury, win->begx + win->curx);
+                }
+                mcurses_addch_or_insch (ch, FALSE);
+                win->curx += w;
+
+                if (win->curx == win->maxx)                                     // wrap at right edge of window
+                {
+                    mcurses_wnewline (win);
+                }
+            }
+            return;
+    }
+    move (win->begy + win->cury, win->begx + win->curx);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add character to window, lines wrap at the right edge of the window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+waddch (WINDOW * win, uint8_t ch)
+{
+    mcurses_waddch (win, ch);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add Unicode character to window, see add_wch()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+wadd_wch (WINDOW * win, uint32_t ch)
+{
+#if MCURSES_UTF8
+    mcurses_waddch (win, ch);
+#else
+    mcurses_waddch (win, (ch <= 0xFF) ? ch : '?');
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add string to window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+waddstr (WINDOW * win, char * str)
+{
+    waddnstr (win, str, -1);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw border at the edges of window, see border(). The cursor stays.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+wborder (WINDOW * win, uint8_t ls, uint8_t rs, uint8_t ts, uint8_t bs, uint8_t tl, uint8_t tr, uint8_t bl, uint8_t br)
+{
+    uint8_t     c[8];
+
+    if (win->maxy < 2 || win->maxx < 2)
+    {
+        return;
+    }
+
+    c[0] = ls; c[1] = rs; c[2] = ts; c[3] = bs; c[4] = tl; c[5] = tr; c[6] = bl; c[7] = br;
+    mcurses_border_chars (c);
+    mcurses_border (win->begy, win->begx, win->maxy, win->maxx, c);
+#if ! MCURSES_VIRTUAL_SCREEN
+    mymove (mcurses_cury, mcurses_curx);
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw horizontal line of n characters ch from the cursor of window to its right edge, see hline()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+whline (WINDOW * win, uint8_t ch, uint8_t n)
+{
+    if (n > win->maxx - win->curx)
+    {
+        n = win->maxx - win->curx;
+    }
+
+    move (win->begy + win->cury, win->begx + win->curx);
+    hline (ch, n);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: draw vertical line of n characters ch from the cursor of window to its bottom edge, see vline()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+wvline (WINDOW * win, uint8_t ch, uint8_t n)
+{
+    if (n > win->maxy - win->cury)
+    {
+        n = win->maxy - win->cury;
+    }
+
+    move (win->begy + win->cury, win->begx + win->curx);
+    vline (ch, n);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: copy up to n cells to the current line of window, up to the right edge of window if n < 0, see addchnstr()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+waddchnstr (WINDOW * win, const chtype * cp, int16_t n)
+{
+    uint8_t     room = win->maxx - win->curx;
+
+    if (n < 0 || n > room)
+    {
+        n = room;
+    }
+
+    if (mcurses_cury != win->begy + win->cury || mcurses_curx != win->begx + win->curx)
+    {
+        move (win->begy + win->cury, win->begx + win->curx);
+    }
+    addchnstr (cp, n);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add up to n characters of string to window, all if n < 0
+ *
+ * Runs of printable characters up to the right edge of the window are added in one block, see addnstr().
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+waddnstr (WINDOW * win, const char * str, int16_t n)
+{
+#if MCURSES_UTF8
+    MCURSES_CHAR    wc;
+#endif
+    uint8_t         ch;
+    uint8_t         room;
+    uint8_t         len;
+
+    while (n != 0 && (ch = *str) != '\0')
+    {
+        if (! IS_RUN_CHAR (ch))
+        {
+#if MCURSES_UTF8
+            len = mcurses_utf8_decode (str, n, &wc);
+            mcurses_waddch (win, wc);
+#else
+            mcurses_waddch (win, ch);
+            len = 1;
+#endif
+        }
+        else
+        {
+            room = win->maxx - win->curx;
+
+            for (len = 1; len < room && len != n; len++)
+            {
+                ch = str[len];
+
+                if (! IS_RUN_CHAR (ch))
+                {
+                    break;
+                }
+            }
+
+            if (mcurses_cury != win->begy + win->cury || mcurses_curx != win->begx + win->curx)
+            {
+                move (win->begy + win->cury, win->begx + win->curx);
+            }
+
+            mcurses_addnstr (str, len);
+            win->curx += len;
+
+            if (win->curx == win->maxx)                                         // wrap at right edge of window
+            {
+                mcurses_wnewline (win);
+            }
+        }
+
+        str += len;
+
+        if (n > 0)
+        {
+            n -= len;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: add string of Unicode characters to window
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+waddwstr (WINDOW * win, const wchar_t * str)
+{
+    while (*str)
+    {
+        wadd_wch (win, *str++);
+    }
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: formatted output to window, see printw()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+void
+wprintw (WINDOW * win, const char * fmt, ...)
+{
+    va_list     ap;
+
+    va_start (ap, fmt);
+    mcurses_vprintw (win, fmt, FALSE, ap);
+    va_end (ap);
+}
+
+void
+curs_set (uint8_t visibility)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_cursor_vis = visibility;                                            // sent by refresh()
+#else
+    mcurses_puts_P (SEQ_CURSOR_VIS);
+
+    if (visibility == 0)
+    {
+        mcurses_putc ('l');
+    }
+    else
+    {
+        mcurses_putc ('h');
+    }
+#endif
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: send a frame: update terminal, end synchronized update and flush output
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static void
+mcurses_refresh_frame (void)
+{
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_update ();
+    mcurses_frame_pending = FALSE;
+    SHARED_STORE (mcurses_frame_blocked, FALSE);
+#endif
+
+    if (mcurses_sync_frame)                                                     // synchronized update open?
+    {                                                                           // yes, end it, terminal shows the whole frame now
+        mcurses_puts_P (SEQ_SYNC_END);
+        mcurses_sync_frame = FALSE;
+    }
+
+    mcurses_phyio_flush_output ();
+
+    mcurses_stats.frames++;
+    mcurses_stats.last_bytes    = mcurses_stats.bytes - mcurses_frame_bytes;
+    mcurses_frame_bytes         = mcurses_stats.bytes;
+
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
+    if (mcurses_frame_period)
+    {
+        mcurses_frame_next = mcurses_phyio_msecs () + mcurses_frame_period;     // next frame not before this time
+    }
+#endif
+}
+
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: return milliseconds until next frame may be sent, 0 if now
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+static int
+mcurses_refresh_delay (void)
+{
+    int32_t     delay;
+
+    if (! mcurses_frame_period)
+    {
+        return 0;
+    }
+
+    delay = (int32_t) (mcurses_frame_next - mcurses_phyio_msecs ());
+
+    if (delay <= 0)
+    {
+        return 0;
+    }
+
+    if (delay > mcurses_frame_period)                                           // clock jumped: don't wait longer than one period
+    {
+        delay = mcurses_frame_period;
+    }
+    return delay;
 }
+#endif
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * INTERN: set scrolling region (raw)
+ * INTERN: check if a frame may be sent now: frame rate not exceeded and - if coalescing - previous frame sent
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-static void
-mysetscrreg (uint8_t top, uint8_t bottom)
+static uint8_t
+mcurses_frame_due (void)
 {
-    if (top == bottom)
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
+    if (mcurses_refresh_delay () > 0)
     {
-        mcurses_puts_P (SEQ_RESET_SCRREG);                                      // reset scrolling region
+        return FALSE;
     }
-    else
+#endif
+
+#if MCURSES_VIRTUAL_SCREEN
+    if (mcurses_coalesce)
     {
-        mcurses_puts_P (SEQ_CSI);
-        mcurses_puti (top + 1);
-        mcurses_putc (';');
-        mcurses_puti (bottom + 1);
-        mcurses_putc ('r');
+        mcurses_phyio_flush_output ();                                          // write as much as possible
+
+        if (mcurses_phyio_pending () > 0)                                       // link still busy?
+        {
+            SHARED_STORE (mcurses_frame_blocked, TRUE);
+            return FALSE;
+        }
     }
+#endif
+
+    return TRUE;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * move cursor (raw)
+ * INTERN: send a skipped frame if it is due now. Returns TRUE if a frame has been sent
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-static void
-mymove (uint8_t y, uint8_t x)
+static uint8_t
+mcurses_output_idle (void)
 {
-    mcurses_puts_P (SEQ_CSI);
-    mcurses_puti (y + 1);
-    mcurses_putc (';');
-    mcurses_puti (x + 1);
-    mcurses_putc ('H');
+    if (mcurses_frame_pending && mcurses_frame_due ())
+    {
+        mcurses_refresh_frame ();
+        return TRUE;
+    }
+    return FALSE;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: initialize
+ * MCURSES: refresh: send changes and flush output
+ *
+ * If the frame rate would be exceeded or - with coalescing - the terminal has not yet received the previous frame, the
+ * frame is skipped. It is sent later by refresh(), getch() or outdrain(), when it is due - showing the latest state of
+ * the screen.
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-initscr (void)
+refresh (void)
 {
-    mcurses_phyio_init ();
-    mcurses_puts_P (SEQ_LOAD_G1);                                               // load graphic charset into G1
-    clear ();
-    move (0, 0);
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_frame_pending = TRUE;
+
+    if (! mcurses_frame_due ())                                                 // skip this frame
+    {
+        mcurses_stats.skipped++;
+        return;
+    }
+#endif
+
+    mcurses_refresh_frame ();
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: add character
+ * MCURSES: doupdate: send changes now, regardless of frame rate and coalescing, e.g. to echo a key
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-addch (uint8_t ch)
+doupdate (void)
 {
-    mcurses_addch_or_insch (ch, FALSE);
+    mcurses_refresh_frame ();
 }
 
+#if MCURSES_VIRTUAL_SCREEN
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: add string
+ * MCURSES: set/reset coalescing: refresh() skips frames while the previous frame is not yet sent
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-addstr (char * str)
+coalesce (uint8_t flag)
 {
-    while (*str)
+    mcurses_coalesce = flag;
+
+    if (! flag)
     {
-        mcurses_addch_or_insch (*str++, FALSE);
+        (void) mcurses_output_idle ();
     }
 }
+#endif
 
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: add string
+ * MCURSES: set maximum frame rate in frames per second, 0 = unlimited
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-addstr_P (const char * str)
+refreshrate (uint8_t fps)
 {
-    uint8_t ch;
+    mcurses_frame_period = fps ? (1000 + fps - 1) / fps : 0;
 
-    while ((ch = pgm_read_byte(str)) != '\0')
+    if (! fps)
     {
-        mcurses_addch_or_insch (ch, FALSE);
-        str++;
+        (void) mcurses_output_idle ();
     }
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: set attribute(s)
+ * MCURSES: return milliseconds until a skipped frame is due, -1 if no frame is pending. Usable as timeout for poll()
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-void
-attrset (uint16_t attr)
+int
+refreshdelay (void)
 {
-    uint8_t         idx;
-
-    mcurses_puts_P (SEQ_ATTRSET);
-
-    idx = (attr & F_COLOR) >> 8;
-
-    if (idx >= 1 && idx <= 8)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_FCOLOR);
-        mcurses_putc (idx - 1 + '0');
-    }
-
-    idx = (attr & B_COLOR) >> 12;
-
-    if (idx >= 1 && idx <= 8)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_BCOLOR);
-        mcurses_putc (idx - 1 + '0');
-    }
-
-    if (attr & A_REVERSE)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_REVERSE);
-    }
-    if (attr & A_UNDERLINE)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_UNDERLINE);
-    }
-    if (attr & A_BLINK)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_BLINK);
-    }
-    if (attr & A_BOLD)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_BOLD);
-    }
-    if (attr & A_DIM)
-    {
-        mcurses_puts_P (SEQ_ATTRSET_DIM);
-    }
-    mcurses_putc ('m');
+    return mcurses_frame_pending ? mcurses_refresh_delay () : -1;
 }
+#endif
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: move cursor
+ * MCURSES: return number of characters not yet sent to the terminal
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-void
-move (uint8_t y, uint8_t x)
+uint32_t
+outpending (void)
 {
-    mcurses_cury = y;
-    mcurses_curx = x;
-    mymove (y, x);
+    return mcurses_phyio_pending ();
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: delete line
+ * MCURSES: get statistics
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-deleteln (void)
+getstats (MCURSES_STATS * stats)
 {
-    mysetscrreg (mcurses_scrl_start, mcurses_scrl_end);                         // set scrolling region
-    mymove (mcurses_cury, 0);                                                   // goto to current line
-    mcurses_puts_P (SEQ_DELETELINE);                                            // delete line
-    mysetscrreg (0, 0);                                                         // reset scrolling region
-    move (mcurses_cury, mcurses_curx);                                          // restore position
+    *stats = mcurses_stats;
+    stats->throughput = SHARED_LOAD (mcurses_throughput);
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: insert line
+ * MCURSES: reset statistics, the throughput estimate is kept
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-insertln (void)
+clearstats (void)
 {
-    mysetscrreg (mcurses_cury, mcurses_scrl_end);                               // set scrolling region
-    mymove (mcurses_cury, 0);                                                   // goto to current line
-    mcurses_puts_P (SEQ_INSERTLINE);                                            // insert line
-    mysetscrreg (0, 0);                                                         // reset scrolling region
-    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+    memset (&mcurses_stats, 0, sizeof (mcurses_stats));                         // throughput lives in mcurses_throughput
+    mcurses_frame_bytes = 0;
 }
 
+#if defined(unix)
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: scroll
+ * MCURSES: set asynchronous output: ASYNC_OFF, ASYNC_POLL (drained by application) or ASYNC_THREAD (drained by helper thread)
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-scroll (void)
+asyncoutput (uint8_t mode)
 {
-    mysetscrreg (mcurses_scrl_start, mcurses_scrl_end);                         // set scrolling region
-    mymove (mcurses_scrl_end, 0);                                               // goto to last line of scrolling region
-    mcurses_puts_P (SEQ_NEXTLINE);                                              // next line
-    mysetscrreg (0, 0);                                                         // reset scrolling region
-    mymove (mcurses_cury, mcurses_curx);                                        // restore position
+    mcurses_phyio_async (mode);
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: clear
+ * MCURSES: return fd to poll for POLLOUT while outpending() > 0, -1 if asynchronous output is not set
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-void
-clear (void)
+int
+outfd (void)
 {
-    mcurses_puts_P (SEQ_CLEAR);
+    return mcurses_outfd;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: clear to bottom of screen
+ * MCURSES: write pending output without blocking, return number of characters still pending
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-void
-clrtobot (void)
+uint32_t
+outdrain (void)
 {
-    mcurses_puts_P (SEQ_CLRTOBOT);
+    uint32_t    pending;
+
+    do
+    {
+        if (mcurses_async == ASYNC_POLL)
+        {
+            pending = mcurses_outq_write ();
+        }
+        else
+        {
+            pending = mcurses_phyio_pending ();
+        }
+    } while (pending == 0 && mcurses_output_idle ());                           // drained: send skipped frame, if any
+
+    return pending;
 }
+#endif
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: clear to end of line
+ * MCURSES: set/reset synchronized output (DEC mode 2026), the output between two calls of refresh() is shown as one frame
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-clrtoeol (void)
+syncoutput (uint8_t flag)
 {
-    mcurses_puts_P (SEQ_CLRTOEOL);
+    if (flag)
+    {
+        if (! mcurses_sync)
+        {
+            mcurses_puts_P (SEQ_SYNC_QUERY);                                    // ask terminal, answer is read by getch()
+                                                                                // frames are bracketed only after that
+            mcurses_sync = TRUE;
+        }
+    }
+    else
+    {
+        if (mcurses_sync_frame)                                                 // close open synchronized update
+        {
+            mcurses_puts_P (SEQ_SYNC_END);
+            mcurses_sync_frame = FALSE;
+        }
+        mcurses_sync = FALSE;
+    }
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: delete character at cursor position
+ * MCURSES: set/reset counted repeats (REP, "ESC [ n b") for runs of equal characters, e.g. for xterm. Off by default,
+ * because VT100 and VT220 don't know REP.
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-delch (void)
+repoutput (uint8_t flag)
 {
-    mcurses_puts_P (SEQ_DELCH);
+    mcurses_rep = flag;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: insert character
+ * MCURSES: set/reset rectangular area operations (VT420 DECFRA, DECERA, DECCRA) for fillrect(), eraserect(), copyrect(),
+ * werase() and wscrl(). They are used only after the terminal has reported rectangular editing in its device attributes.
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-insch (uint8_t ch)
+rectoutput (uint8_t flag)
 {
-    mcurses_addch_or_insch (ch, TRUE);
+    if (flag && ! mcurses_rect)
+    {
+        mcurses_puts_P (SEQ_DA_QUERY);                                          // ask terminal, answer is read by getch()
+    }
+    mcurses_rect = flag;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: set scrolling region
+ * MCURSES: set/reset left/right margins (DECLRMM, DECSLRM) for wscrl() of windows narrower than the screen. They are used
+ * only after the terminal has reported support of DEC mode 69.
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
-setscrreg (uint8_t t, uint8_t b)
-{
-    mcurses_scrl_start = t;
-    mcurses_scrl_end = b;
-}
-
-void
-curs_set (uint8_t visibility)
+marginoutput (uint8_t flag)
 {
-    mcurses_puts_P (SEQ_CURSOR_VIS);
-
-    if (visibility == 0)
+    if (flag)
     {
-        mcurses_putc ('l');
+        if (! mcurses_margins)
+        {
+            mcurses_puts_P (SEQ_MARGINS_QUERY);                                 // ask terminal, answer is read by getch()
+        }
     }
-    else
+    else if (mcurses_lrmm)
     {
-        mcurses_putc ('h');
+        mcurses_puts_P (SEQ_MARGINS_OFF);
+        mcurses_lrmm = FALSE;
     }
+    mcurses_margins = flag;
 }
 
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: check if terminal has reported support of left/right margins
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+has_marginoutput (void)
+{
+    return (mcurses_termcaps & TERMCAP_MARGINS) ? TRUE : FALSE;
+}
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: refresh: flush output
+ * MCURSES: check if terminal has reported rectangular editing
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-void
-refresh (void)
+uint8_t
+has_rectoutput (void)
 {
-    mcurses_phyio_flush_output ();
+    return (mcurses_termcaps & TERMCAP_RECT) ? TRUE : FALSE;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * MCURSES: check if terminal has reported support of synchronized output
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+uint8_t
+has_syncoutput (void)
+{
+    return (mcurses_termcaps & TERMCAP_SYNC) ? TRUE : FALSE;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -946,11 +5842,101 @@ nodelay (uint8_t flag)
     }
 }
 
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * INTERN: read a terminal report after "ESC [ ?", e.g. DECRPM "ESC [ ? 2026 ; 2 $ y" or DA1 "ESC [ ? 64 ; 1 ; 28 c"
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+#define MAX_REPORT_PARAMS       4
+
+static void
+mcurses_read_report (void)
+{
+    uint16_t    param[MAX_REPORT_PARAMS];
+    uint8_t     nparams = 0;
+    uint8_t     intermediate = 0;
+    uint8_t     rect = FALSE;
+    uint8_t     ch;
+
+    param[0] = 0;
+
+    while (1)
+    {
+        while ((ch = mcurses_phyio_getc ()) == ERR)
+        {
+            ;
+        }
+
+        if (ch >= '0' && ch <= '9')
+        {
+            param[nparams] = 10 * param[nparams] + (ch - '0');
+        }
+        else if (ch == ';')
+        {
+            if (nparams > 0 && param[nparams] == 28)                            // DA1 extension 28: rectangular editing
+            {
+                rect = TRUE;
+            }
+
+            if (nparams < MAX_REPORT_PARAMS - 1)                                // long DA1 list: reuse last parameter
+            {
+                nparams++;
+            }
+            param[nparams] = 0;
+        }
+        else if (ch >= 0x20 && ch <= 0x2F)                                      // intermediate character, e.g. '$'
+        {
+            intermediate = ch;
+        }
+        else                                                                    // final character
+        {
+            break;
+        }
+    }
+
+    if (ch == 'y' && intermediate == '$' && nparams == 1)                       // DECRPM: mode ; value $ y
+    {
+        if (param[0] == 2026)                                                   // synchronized output
+        {
+            if (param[1] >= 1 && param[1] <= 3)                                 // 1 = set, 2 = reset, 3 = permanently set
+            {
+                mcurses_termcaps |= TERMCAP_SYNC;
+            }
+            else                                                                // 0 = not recognized, 4 = permanently reset
+            {
+                mcurses_termcaps &= ~TERMCAP_SYNC;
+                mcurses_sync = FALSE;                                           // don't waste bytes on it
+            }
+        }
+        else if (param[0] == 69)                                                // left/right margins
+        {
+            if (param[1] >= 1 && param[1] <= 3)
+            {
+                mcurses_termcaps |= TERMCAP_MARGINS;
+            }
+            else
+            {
+                mcurses_termcaps &= ~TERMCAP_MARGINS;
+            }
+        }
+    }
+    else if (ch == 'c' && ! intermediate)                                      // DA1: class ; extensions c
+    {
+        if (rect || (nparams > 0 && param[nparams] == 28))
+        {
+            mcurses_termcaps |= TERMCAP_RECT;
+        }
+        else
+        {
+            mcurses_termcaps &= ~TERMCAP_RECT;
+        }
+    }
+}
+
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * MCURSES: read key
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
-#define MAX_KEYS                ((KEY_F1 + 12) - 0x80)
+#define MAX_KEYS                ((KEY_CRIGHT + 1) - 0x80)
 
 static const char * function_keys[MAX_KEYS] =
 {
@@ -984,75 +5970,96 @@ static const char * function_keys[MAX_KEYS] =
     "20~",                      // KEY_F(9)                 0x93                // Function key F9
     "21~",                      // KEY_F(10)                0x94                // Function key F10
     "23~",                      // KEY_F(11)                0x95                // Function key F11
-    "24~"                       // KEY_F(12)                0x96                // Function key F12
+    "24~",                      // KEY_F(12)                0x96                // Function key F12
+    "1;5D",                     // KEY_CLEFT                0x97                // Ctrl + left arrow key
+    "1;5C"                      // KEY_CRIGHT               0x98                // Ctrl + right arrow key
 };
 
 uint8_t
 getch (void)
 {
-    char    buf[4];
+    char    buf[5];
     uint8_t ch;
     uint8_t idx;
 
-    refresh ();
-    ch = mcurses_phyio_getc ();
-
-    if (ch == 0x7F)                                                             // BACKSPACE on VT200 sends DEL char
+    if (mcurses_nodelay)
     {
-        ch = KEY_BACKSPACE;                                                     // map it to '\b'
+        refresh ();
     }
-    else if (ch == '\033')                                                      // ESCAPE
+    else
     {
-        while ((ch = mcurses_phyio_getc ()) == ERR)
-        {
-            ;
-        }
+        doupdate ();                                                            // user waits for screen: show it now
+    }
 
-        if (ch == '\033')                                                       // 2 x ESCAPE
+    while (1)
+    {
+        ch = mcurses_phyio_getc ();
+
+        if (ch == 0x7F)                                                         // BACKSPACE on VT200 sends DEL char
         {
-            return KEY_ESCAPE;
+            ch = KEY_BACKSPACE;                                                 // map it to '\b'
         }
-        else if (ch == '[')
+        else if (ch == '\033')                                                  // ESCAPE
         {
-            for (idx = 0; idx < 3; idx++)
+            while ((ch = mcurses_phyio_getc ()) == ERR)
+            {
+                ;
+            }
+
+            if (ch == '\033')                                                   // 2 x ESCAPE
+            {
+                return KEY_ESCAPE;
+            }
+            else if (ch == '[')
             {
-                while ((ch = mcurses_phyio_getc ()) == ERR)
+                for (idx = 0; idx < 4; idx++)
                 {
-                    ;
+                    while ((ch = mcurses_phyio_getc ()) == ERR)
+                    {
+                        ;
+                    }
+
+                    buf[idx] = ch;
+
+                    if ((ch >= 'A' && ch <= 'Z') || ch == '~' || (idx == 0 && ch == '?'))
+                    {
+                        idx++;
+                        break;
+                    }
                 }
 
-                buf[idx] = ch;
+                buf[idx] = '\0';
 
-                if ((ch >= 'A' && ch <= 'Z') || ch == '~')
+                if (buf[0] == '?')                                              // terminal report, not a key
                 {
-                    idx++;
-                    break;
+                    mcurses_read_report ();
+                    continue;                                                   // read next key (or return ERR if nodelay)
                 }
-            }
-
-            buf[idx] = '\0';
 
-            for (idx = 0; idx < MAX_KEYS; idx++)
-            {
-                if (! strcmp (buf, function_keys[idx]))
+                for (idx = 0; idx < MAX_KEYS; idx++)
                 {
-                    ch = idx + 0x80;
-                    break;
+                    if (! strcmp (buf, function_keys[idx]))
+                    {
+                        ch = idx + 0x80;
+                        break;
+                    }
                 }
-            }
 
-            if (idx == MAX_KEYS)
-            {
-                ch = KEY_ESCAPE;
+                if (idx == MAX_KEYS)
+                {
+                    ch = KEY_ESCAPE;
+                }
             }
         }
+        break;
     }
 
     return ch;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
- * MCURSES: read string (with mini editor built-in)
+ * MCURSES: read string of up to maxlen - 1 characters (with mini editor built-in). No history, every key moves the cursor
+ * and inserts or deletes on the screen - for longer input see editgetnstr() of the line editor (mcurses-edit.c).
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 void
@@ -1146,9 +6153,23 @@ endwin (void)
 {
     move (LINES - 1, 0);                                                        // move cursor to last line
     clrtoeol ();                                                                // clear this line
-    mcurses_putc ('\017');                                                      // switch to G0 set
     curs_set (TRUE);                                                            // show cursor
+#if MCURSES_VIRTUAL_SCREEN
+    mcurses_update ();                                                          // send last frame, even if skipped
+#endif
+    if (mysetscrreg (0, 0))                                                     // reset scrolling region, cursor goes home
+    {
+        mymove (LINES - 1, 0);
+    }
+    if (mcurses_lrmm)                                                           // forbid left/right margins again
+    {
+        mcurses_puts_P (SEQ_MARGINS_OFF);
+        mcurses_lrmm = FALSE;
+    }
+#if ! MCURSES_UNICODE_ACS
+    mcurses_putc ('\017');                                                      // switch to G0 set
+#endif
     mcurses_puts_P(SEQ_REPLACE_MODE);                                            // reset insert mode
-    refresh ();                                                                 // flush output
+    mcurses_refresh_frame ();                                                   // flush output
     mcurses_phyio_done ();                                                      // end of physical I/O
 }
@@ -10,7 +10,11 @@
  *---------------------------------------------------------------------------------------------------------------------------------------------------
  */
 
+#ifndef MCURSES_H
+#define MCURSES_H
+
 #include <stdint.h>
+#include <stddef.h>
 
 #if defined(unix)
 #elif defined(__SDCC_z80)
@@ -31,6 +35,64 @@
 #define OK                      (0)                                                 // yet not used
 #define ERR                     (255)                                               // yet not used
 
+#if MCURSES_UTF8
+#define CHAR_BYTES              4                                                   // max. bytes of a character in a string: UTF-8
+#else
+#define CHAR_BYTES              1                                                   // max. bytes of a character in a string
+#endif
+
+#define ASYNC_OFF               0                                                   // asyncoutput(): write output blocking (default)
+#define ASYNC_POLL              1                                                   // asyncoutput(): queue output, application drains
+#define ASYNC_THREAD            2                                                   // asyncoutput(): queue output, helper thread drains
+
+#define STRATEGY_DELTA          0                                                   // refresh(): send changed cells only
+#define STRATEGY_LINE           1                                                   // refresh(): send changed lines from first to last change
+#define STRATEGY_FULL           2                                                   // refresh(): clear screen and send everything
+#define STRATEGIES              3                                                   // number of strategies
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * statistics, see getstats()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint32_t    frames;                                                             // frames sent by refresh()
+    uint32_t    skipped;                                                            // frames skipped by refreshrate() or coalesce()
+    uint32_t    bytes;                                                              // bytes sent
+    uint32_t    throughput;                                                         // estimated throughput of link in bytes/sec
+    uint32_t    last_bytes;                                                         // bytes of last frame
+    uint32_t    last_usecs;                                                         // predicted time on the wire of last frame in usec
+    uint8_t     last_strategy;                                                      // strategy of last frame: STRATEGY_xxx
+    uint32_t    strategy[STRATEGIES];                                               // number of frames per strategy
+} MCURSES_STATS;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * cell: character with attributes, see addchnstr(). A row of cells ends with ch == 0, if shorter than n.
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t     ch;                                                                 // character, 0x80-0x9F: ACS character, 0xA0-0xFF: ISO-8859-1
+    uint16_t    attr;                                                               // attributes
+} chtype;
+
+/*---------------------------------------------------------------------------------------------------------------------------------------------------
+ * window: rectangle of the screen with own cursor and scrolling region, see newwin()
+ *---------------------------------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+    uint8_t     begy;                                                               // top line on screen
+    uint8_t     begx;                                                               // left column on screen
+    uint8_t     maxy;                                                               // number of lines
+    uint8_t     maxx;                                                               // number of columns
+    uint8_t     cury;                                                               // cursor line in window
+    uint8_t     curx;                                                               // cursor column in window
+    uint8_t     scrl_start;                                                         // start of scrolling region in window
+    uint8_t     scrl_end;                                                           // end of scrolling region in window
+    uint8_t     scroll;                                                             // TRUE: waddch() scrolls, see scrollok()
+} WINDOW;
+
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * attributes, may be ORed
  *---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -65,6 +127,21 @@
 #define B_YELLOW                B_BROWN                                             // some terminals show brown as yellow (with A_BOLD)
 #define B_COLOR                 0xF000                                              // background mask
 
+#define A_COLORPAIR             0x0020                                              // bits 8-15 hold a color pair, see COLOR_PAIR()
+#define COLOR_PAIR(n)           (A_COLORPAIR | ((uint16_t) (n) << 8))               // colors of pair n instead of F_xxx/B_xxx, see init_pair()
+
+#define COLOR_DEFAULT           (-1)                                                // colors of init_pair(), 8...255: palette of terminal
+#define COLOR_BLACK             0                                                   // black
+#define COLOR_RED               1                                                   // red
+#define COLOR_GREEN             2                                                   // green
+#define COLOR_BROWN             3                                                   // brown
+#define COLOR_BLUE              4                                                   // blue
+#define COLOR_MAGENTA           5                                                   // magenta
+#define COLOR_CYAN              6                                                   // cyan
+#define COLOR_WHITE             7                                                   // white
+#define COLOR_YELLOW            COLOR_BROWN                                         // some terminals show brown as yellow (with A_BOLD)
+#define COLOR_RGB(r,g,b)        ((int32_t) (0x01000000L | ((uint32_t) (r) << 16) | ((uint16_t) (g) << 8) | (uint8_t) (b)))  // 24 bit color
+
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * mcurses variables
  *---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -79,14 +156,34 @@ extern uint8_t                  mcurses_curx;
 extern void                     initscr (void);                                     // initialize mcurses
 extern void                     move (uint8_t, uint8_t);                            // move cursor to line, column (home = 0, 0)
 extern void                     attrset (uint16_t);                                 // set attribute(s)
+extern uint16_t                 getattrs (void);                                    // get attribute(s) set by attrset()
+extern uint8_t                  init_pair (uint8_t, int32_t, int32_t);              // set colors of pair: pair, foreground, background
 extern void                     addch (uint8_t);                                    // add a character
 extern void                     addstr (char *);                                    // add a string
 extern void                     addstr_P (const char *);                            // add a string (PROGMEM)
-extern void                     getnstr (char * str, uint8_t maxlen);               // read a string (with mini editor functionality)
+extern void                     addnstr (const char *, int16_t);                    // add max. n characters of a string, all if n < 0
+extern int16_t                  strfit (const char *, int16_t, uint8_t, uint8_t *); // bytes of max. n bytes of string fitting into cols columns
+extern void                     add_wch (uint32_t);                                 // add a Unicode character (UTF-8 terminal)
+extern void                     addwstr (const wchar_t *);                          // add a string of Unicode characters
+extern void                     printw (const char *, ...);                         // formatted output: %d %u %x %X %c %s, width, '-', '0', 'l'
+extern void                     printw_P (const char *, ...);                       // formatted output, format string in PROGMEM
+extern void                     addchnstr (const chtype *, int16_t);                // copy max. n cells to line, cursor stays, all if n < 0
+#if MCURSES_VIRTUAL_SCREEN
+extern int16_t                  inchnstr (chtype *, int16_t);                       // read max. n cells of line, cursor stays, all if n < 0
+#endif
+extern void                     hline (uint8_t, uint8_t);                           // draw horizontal line: ch (0 = ACS_HLINE), length
+extern void                     vline (uint8_t, uint8_t);                           // draw vertical line: ch (0 = ACS_VLINE), length
+extern void                     border (uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t);   // draw border around screen
+extern void                     fillrect (uint8_t, uint8_t, uint8_t, uint8_t, uint8_t); // fill rectangle: line, column, lines, columns, ch
+extern void                     eraserect (uint8_t, uint8_t, uint8_t, uint8_t);     // erase rectangle: line, column, lines, columns
+extern uint8_t                  copyrect (uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t);   // copy rectangle: ..., to line, column
+extern void                     getnstr (char * str, uint8_t maxlen);               // read a string (mini editor), longer: editgetnstr()
 extern void                     setscrreg (uint8_t, uint8_t);                       // set scrolling region
 extern void                     deleteln (void);                                    // delete line at current line position
 extern void                     insertln (void);                                    // insert a line at current line position
+extern void                     insdelln (int8_t);                                  // insert n lines (n > 0) or delete -n lines (n < 0)
 extern void                     scroll (void);                                      // scroll line up
+extern void                     scrl (int16_t);                                     // scroll n lines up (n > 0) or -n lines down (n < 0)
 extern void                     clear (void);                                       // clear total screen
 extern void                     clrtobot (void);                                    // clear screen from current line to bottom
 extern void                     clrtoeol (void);                                    // clear from current column to end of line
@@ -96,6 +193,47 @@ extern void                     nodelay (uint8_t);
 extern uint8_t                  getch (void);                                       // read key
 extern void                     curs_set(uint8_t);                                  // set cursor to: 0=invisible 1=normal 2=very visible
 extern void                     refresh (void);                                     // flush output
+extern void                     doupdate (void);                                    // send changes now, ignore refreshrate() and coalesce()
+#if MCURSES_VIRTUAL_SCREEN
+extern void                     coalesce (uint8_t);                                 // set/reset coalescing of frames while output is busy
+#endif
+#if defined(unix) && MCURSES_VIRTUAL_SCREEN
+extern void                     refreshrate (uint8_t);                              // set max. frames per second, 0 = unlimited
+extern int                      refreshdelay (void);                                // msec until skipped frame is due, -1 if none
+#endif
+extern void                     syncoutput (uint8_t);                               // set/reset synchronized output (DEC mode 2026), see has_syncoutput()
+extern uint8_t                  has_syncoutput (void);                              // TRUE if getch() read terminal's sync confirmation
+extern void                     repoutput (uint8_t);                                // set/reset counted repeats (REP) of characters
+extern void                     rectoutput (uint8_t);                               // set/reset rectangular area operations (DECFRA etc.)
+extern uint8_t                  has_rectoutput (void);                              // TRUE if terminal reported rectangular editing
+extern void                     marginoutput (uint8_t);                             // set/reset left/right margins (DECSLRM) for wscrl()
+extern uint8_t                  has_marginoutput (void);                            // TRUE if terminal reported left/right margins
+extern uint32_t                 outpending (void);                                  // number of characters not yet sent
+extern void                     getstats (MCURSES_STATS *);                         // get statistics
+extern void                     clearstats (void);                                  // reset statistics
+#if defined(unix)
+extern void                     asyncoutput (uint8_t);                              // set asynchronous output: ASYNC_xxx
+extern int                      outfd (void);                                       // fd to poll for POLLOUT if outpending() > 0
+extern uint32_t                 outdrain (void);                                    // write pending output without blocking
+#endif
+extern WINDOW *                 newwin (uint8_t, uint8_t, uint8_t, uint8_t);        // create window: lines, columns, begin line, begin column
+extern void                     delwin (WINDOW *);                                  // delete window
+extern uint8_t                  wmove (WINDOW *, uint8_t, uint8_t);                 // move cursor in window
+extern void                     waddch (WINDOW *, uint8_t);                         // add a character to window
+extern void                     waddstr (WINDOW *, char *);                         // add a string to window
+extern void                     waddnstr (WINDOW *, const char *, int16_t);         // add max. n characters of a string to window
+extern void                     wadd_wch (WINDOW *, uint32_t);                      // add a Unicode character to window
+extern void                     waddwstr (WINDOW *, const wchar_t *);               // add a string of Unicode characters to window
+extern void                     wprintw (WINDOW *, const char *, ...);              // formatted output to window, see printw()
+extern void                     waddchnstr (WINDOW *, const chtype *, int16_t);     // copy max. n cells to line of window, cursor stays
+extern void                     whline (WINDOW *, uint8_t, uint8_t);                // draw horizontal line in window
+extern void                     wvline (WINDOW *, uint8_t, uint8_t);                // draw vertical line in window
+extern void                     wborder (WINDOW *, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t);  // draw border of window
+extern void                     wclrtoeol (WINDOW *);                               // clear window from cursor to end of line
+extern void                     werase (WINDOW *);                                  // clear window
+extern uint8_t                  wsetscrreg (WINDOW *, uint8_t, uint8_t);            // set scrolling region of window
+extern void                     scrollok (WINDOW *, uint8_t);                       // allow/forbid scrolling of window by waddch()
+extern uint8_t                  wscrl (WINDOW *, int16_t);                          // scroll window n lines up (n > 0) or -n lines down (n < 0)
 extern void                     endwin (void);                                      // end mcurses
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
@@ -106,10 +244,31 @@ extern void                     endwin (void);
 #define mvaddch(y,x,c)          move((y),(x)), addch((c))                           // move cursor, then add character
 #define mvaddstr(y,x,s)         move((y),(x)), addstr((s))                          // move cursor, then add string
 #define mvaddstr_P(y,x,s)       move((y),(x)), addstr_P((s))                        // move cursor, then add string (PROGMEM)
+#define mvaddnstr(y,x,s,n)      move((y),(x)), addnstr((s),(n))                     // move cursor, then add max. n characters of string
+#define mvadd_wch(y,x,c)        move((y),(x)), add_wch((c))                         // move cursor, then add Unicode character
+#define mvaddwstr(y,x,s)        move((y),(x)), addwstr((s))                         // move cursor, then add string of Unicode characters
+#define mvprintw(y,x,...)       move((y),(x)), printw(__VA_ARGS__)                  // move cursor, then formatted output
+#define mvprintw_P(y,x,...)     move((y),(x)), printw_P(__VA_ARGS__)                // move cursor, then formatted output (PROGMEM)
+#define addchstr(s)             addchnstr((s),-1)                                   // copy cells up to end of line
+#define mvaddchstr(y,x,s)       move((y),(x)), addchnstr((s),-1)                    // move cursor, then copy cells up to end of line
+#define mvaddchnstr(y,x,s,n)    move((y),(x)), addchnstr((s),(n))                   // move cursor, then copy max. n cells
+#define mvhline(y,x,c,n)        move((y),(x)), hline((c),(n))                       // move cursor, then draw horizontal line
+#define mvvline(y,x,c,n)        move((y),(x)), vline((c),(n))                       // move cursor, then draw vertical line
+#define box(w,v,h)              wborder((w),(v),(v),(h),(h),0,0,0,0)                // draw border of window with ACS corners
 #define mvinsch(y,x,c)          move((y),(x)), insch((c))                           // move cursor, then insert character
 #define mvdelch(y,x)            move((y),(x)), delch()                              // move cursor, then delete character
 #define mvgetnstr(y,x,s,n)      move((y),(x)), getnstr(s,n)                         // move cursor, then get string
 #define getyx(y,x)              y = mcurses_cury, x = mcurses_curx                  // get cursor coordinates
+#define mvwaddch(w,y,x,c)       wmove((w),(y),(x)), waddch((w),(c))                 // move cursor in window, then add character
+#define mvwaddstr(w,y,x,s)      wmove((w),(y),(x)), waddstr((w),(s))                // move cursor in window, then add string
+#define mvwaddnstr(w,y,x,s,n)   wmove((w),(y),(x)), waddnstr((w),(s),(n))           // move cursor in window, then add max. n characters
+#define mvwadd_wch(w,y,x,c)     wmove((w),(y),(x)), wadd_wch((w),(c))               // move cursor in window, then add Unicode character
+#define mvwaddwstr(w,y,x,s)     wmove((w),(y),(x)), waddwstr((w),(s))               // move cursor in window, then add string of Unicode characters
+#define mvwprintw(w,y,x,...)    wmove((w),(y),(x)), wprintw((w),__VA_ARGS__)        // move cursor in window, then formatted output
+#define waddchstr(w,s)          waddchnstr((w),(s),-1)                              // copy cells up to right edge of window
+#define mvwaddchnstr(w,y,x,s,n) wmove((w),(y),(x)), waddchnstr((w),(s),(n))         // move cursor in window, then copy max. n cells
+#define getbegyx(w,y,x)         y = (w)->begy, x = (w)->begx                        // get position of window
+#define getmaxyx(w,y,x)         y = (w)->maxy, x = (w)->maxx                        // get size of window
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * mcurses keys
@@ -133,6 +292,8 @@ extern void                     endwin (void);
 #define KEY_BTAB                0x8A                                                // Back tab key
 #define KEY_F1                  0x8B                                                // Function key F1
 #define KEY_F(n)                (KEY_F1+(n)-1)                                      // Space for additional 12 function keys
+#define KEY_CLEFT               0x97                                                // Ctrl + left arrow key: word left
+#define KEY_CRIGHT              0x98                                                // Ctrl + right arrow key: word right
 
 /*---------------------------------------------------------------------------------------------------------------------------------------------------
  * graphics: draw boxes
@@ -170,3 +331,5 @@ extern void                     endwin (void);
 #define ACS_NEQUAL              0x9c                                                // DEC graphic 0x7c: not equal
 #define ACS_STERLING            0x9d                                                // DEC graphic 0x7d: uk pound sign
 #define ACS_BULLET              0x9e                                                // DEC graphic 0x7e: bullet
+
+#endif // MCURSES_H